@@ -0,0 +1,78 @@
+#include "bench_util.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "gl_ext.h"
+#include <stdlib.h>
+#include <time.h>
+
+static EGLDisplay bench_display = EGL_NO_DISPLAY;
+static EGLContext bench_context = EGL_NO_CONTEXT;
+static GLuint bench_framebuffer;
+static GLuint bench_texture;
+
+bool bench_gl_init(uint32_t width, uint32_t height) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    bench_display = get_platform_display
+        ? get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL)
+        : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (bench_display == EGL_NO_DISPLAY || !eglInitialize(bench_display, NULL, NULL)) return false;
+    if (!eglBindAPI(EGL_OPENGL_API)) return false;
+
+    // Compatibility context, as hosts give the editor
+    const EGLint context_attributes[] = { EGL_CONTEXT_MAJOR_VERSION, 2, EGL_CONTEXT_MINOR_VERSION, 1, EGL_NONE };
+    bench_context = eglCreateContext(bench_display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, context_attributes);
+    if (bench_context == EGL_NO_CONTEXT) return false;
+    if (!eglMakeCurrent(bench_display, EGL_NO_SURFACE, EGL_NO_SURFACE, bench_context)) return false;
+    if (!gl_ext_load()) return false;
+
+    glGenTextures(1, &bench_texture);
+    glBindTexture(GL_TEXTURE_2D, bench_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenFramebuffers(1, &bench_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, bench_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, bench_texture, 0);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void bench_gl_shutdown(void) {
+    if (bench_context != EGL_NO_CONTEXT) {
+        glDeleteFramebuffers(1, &bench_framebuffer);
+        glDeleteTextures(1, &bench_texture);
+        eglMakeCurrent(bench_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(bench_display, bench_context);
+        bench_context = EGL_NO_CONTEXT;
+    }
+    if (bench_display != EGL_NO_DISPLAY) {
+        eglTerminate(bench_display);
+        bench_display = EGL_NO_DISPLAY;
+    }
+}
+
+const char *bench_gl_renderer(void) {
+    const GLubyte *renderer = glGetString(GL_RENDERER);
+    return renderer ? (const char *)renderer : "unknown";
+}
+
+uint64_t bench_thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_compare(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_sort(double *samples, uint32_t count) {
+    qsort(samples, count, sizeof(double), bench_compare);
+}
+
+double bench_percentile(const double *sorted, uint32_t count, double p) {
+    if (count == 0) return 0.0;
+    uint32_t index = (uint32_t)(p * (count - 1) + 0.5);
+    return sorted[index];
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Shared benchmark helpers: an offscreen OpenGL context that needs no window
+// or GPU (EGL surfaceless, e.g. Mesa llvmpipe), thread CPU time and percentiles.
+
+// Create a context with a width x height colour buffer bound as the framebuffer
+bool bench_gl_init(uint32_t width, uint32_t height);
+void bench_gl_shutdown(void);
+
+// Renderer string of the current context
+const char *bench_gl_renderer(void);
+
+// CPU time of the calling thread: its own cost, without the time it spends
+// waiting for a (possibly software) rasteriser running on other threads
+uint64_t bench_thread_cpu_ns(void);
+
+// Sort samples in place, then read percentiles (p in [0, 1]) from them
+void bench_sort(double *samples, uint32_t count);
+double bench_percentile(const double *sorted, uint32_t count, double p);
@@ -0,0 +1,122 @@
+/*
+ * Editor grid benchmark
+ * Renders a 4K editor with a 512x256 matrix grid offscreen (EGL, no window)
+ * and checks that a frame at the default quality tier, from matrix update to
+ * glFinish, fits in 2 ms.
+ *
+ * Usage: grid_bench [frames]
+ */
+
+#include "bench_util.h"
+#include "gui.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_WIDTH 3840
+#define BENCH_HEIGHT 2160
+#define BENCH_GRID_WIDTH 512
+#define BENCH_GRID_HEIGHT 256
+#define BENCH_BUDGET_MS 2.0
+#define BENCH_WARMUP_FRAMES 60
+#define BENCH_BLOCK 1024
+
+// Feed a block of noise and draw one frame with every column lit (the worst case
+// for the quad stream); returns editor-thread CPU and wall-to-finish times
+static void bench_frame(gui_context_t *gui, uint32_t *seed, double *cpu_ms, double *finish_ms) {
+    float audio[BENCH_BLOCK];
+    for (uint32_t i = 0; i < BENCH_BLOCK; i++) {
+        *seed = *seed * 1664525u + 1013904223u;
+        audio[i] = (float)(int32_t)*seed * (1.0f / 2147483648.0f);
+    }
+    gui_handle_audio_data(gui, audio, BENCH_BLOCK);
+    gui->spectrum = analysis_worker_latest(&gui->analysis);
+
+    uint64_t start = cpu_meter_now_ns();
+    uint64_t start_cpu = bench_thread_cpu_ns();
+    matrix_update(gui, 1.0f / 60.0f);
+    for (uint32_t i = 0; i < gui->columns.count; i++) {
+        gui->columns.brightness[i] = 1.0f;
+    }
+    gui_render(gui);
+    uint64_t submitted_cpu = bench_thread_cpu_ns();
+    glFinish();
+    gui_frame_presented(gui);
+    uint64_t finished = cpu_meter_now_ns();
+
+    *cpu_ms = (submitted_cpu - start_cpu) * 1.0e-6;
+    *finish_ms = (finished - start) * 1.0e-6;
+}
+
+// Run frames after a warm-up and print percentiles; returns the finish p99
+static double bench_run(gui_context_t *gui, const char *label, uint32_t frames, uint32_t *seed) {
+    double *cpu_ms = (double *)malloc(frames * sizeof(double));
+    double *finish_ms = (double *)malloc(frames * sizeof(double));
+
+    for (uint32_t f = 0; f < BENCH_WARMUP_FRAMES + frames; f++) {
+        double cpu, finish;
+        bench_frame(gui, seed, &cpu, &finish);
+        if (f >= BENCH_WARMUP_FRAMES) {
+            cpu_ms[f - BENCH_WARMUP_FRAMES] = cpu;
+            finish_ms[f - BENCH_WARMUP_FRAMES] = finish;
+        }
+    }
+
+    bench_sort(cpu_ms, frames);
+    bench_sort(finish_ms, frames);
+    double p99 = bench_percentile(finish_ms, frames, 0.99);
+    printf("%-10s tier %u  %5u quads  cpu p50 %7.3f p99 %7.3f ms  finish p50 %8.3f p99 %8.3f ms\n",
+           label, gui->quality.tier, gui->stats.quads, bench_percentile(cpu_ms, frames, 0.5),
+           bench_percentile(cpu_ms, frames, 0.99), bench_percentile(finish_ms, frames, 0.5), p99);
+
+    free(cpu_ms);
+    free(finish_ms);
+    return p99;
+}
+
+int main(int argc, char **argv) {
+    uint32_t frames = argc > 1 ? (uint32_t)atoi(argv[1]) : 300;
+    if (frames < 2) frames = 2;
+
+    if (!bench_gl_init(BENCH_WIDTH, BENCH_HEIGHT)) {
+        fprintf(stderr, "grid_bench: no offscreen OpenGL context\n");
+        return 2;
+    }
+    printf("GL %s / %s\n", glGetString(GL_VERSION), bench_gl_renderer());
+
+    gui_context_t *gui = (gui_context_t *)calloc(1, sizeof(gui_context_t));
+    if (!gui || !gui_create(gui, NULL, BENCH_WIDTH, BENCH_HEIGHT)) {
+        fprintf(stderr, "grid_bench: gui_create failed\n");
+        return 2;
+    }
+
+    // Cells that give the 512x256 grid on a 4K editor
+    gui_set_cell_size(gui, (float)BENCH_WIDTH / BENCH_GRID_WIDTH, (float)BENCH_HEIGHT / BENCH_GRID_HEIGHT);
+    printf("Editor %ux%u, grid %ux%u\n", gui->width, gui->height, gui->grid_width, gui->grid_height);
+    uint32_t seed = 1;
+
+    // Each tier on its own. "cpu" is the editor thread's time in update and render;
+    // "finish" waits for the rasteriser, which on a software renderer also runs on
+    // this machine's CPU and says little about a GPU
+    uint32_t pinned_frames = frames / 4 > 1 ? frames / 4 : 2;
+    for (int32_t tier = 0; tier < QUALITY_TIER_COUNT; tier++) {
+        if (tier == QUALITY_DEFAULT_TIER) continue;
+        gui_set_quality_tier(gui, tier);
+        bench_run(gui, "pinned", pinned_frames, &seed);
+    }
+
+    // The governor as shipped, paced for the default display rate (for reference only:
+    // it lowers the tier until frames fit, so it cannot show the default quality fits)
+    quality_governor_init(&gui->quality, FRAME_SCHEDULER_DEFAULT_HZ);
+    bench_run(gui, "governed", pinned_frames, &seed);
+
+    // The gate: default quality held, timed through glFinish so rasterisation counts
+    gui_set_quality_tier(gui, QUALITY_DEFAULT_TIER);
+    double p99 = bench_run(gui, "default", frames, &seed);
+    printf("%s: default tier %d finish p99 %.3f ms against a %.1f ms budget\n",
+           p99 <= BENCH_BUDGET_MS ? "PASS" : "MISS", QUALITY_DEFAULT_TIER, p99, BENCH_BUDGET_MS);
+
+    gui_destroy(gui);
+    free(gui);
+    bench_gl_shutdown();
+    return p99 <= BENCH_BUDGET_MS ? 0 : 1;
+}
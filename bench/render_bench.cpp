@@ -0,0 +1,319 @@
+/*
+ * Editor render benchmark
+ * Creates the editor with gui_create() on an offscreen context (EGL
+ * surfaceless, so llvmpipe works without a GPU), feeds synthetic audio through
+ * gui_update() and reports draw calls, vertices and frame-time percentiles for
+ * every quality tier. Optional limits turn it into a regression gate:
+ * --max-p99 applies to the time to glFinish on GL and to render time in
+ * software. The software run also fails when an unchanged overlay frame
+ * leaves rows dirty.
+ * --fft and --overlap select the spectrum analysis; each tier also reports
+ * the worker's mean and worst pass time at that size. --cqt switches to
+ * constant-Q bands and fails when the lowest band is above C2.
+ *
+ * Usage: render_bench [--frames N] [--size WxH] [--software] [--csv FILE]
+ *                     [--max-p99 MS] [--max-draws N] [--fft N] [--overlap P]
+ *                     [--cqt]
+ */
+
+#include "bench_util.h"
+#include "gui.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BENCH_WARMUP_FRAMES 60
+#define BENCH_SAMPLE_RATE 48000.0
+#define BENCH_BLOCK 800        // one 60 Hz frame of audio
+#define BENCH_DRAIN_WAIT_MS 100
+#define BENCH_CQT_MAX_FLOOR_HZ 65.41f  // C2
+
+typedef struct {
+    uint32_t frames;
+    uint32_t width;
+    uint32_t height;
+    bool software;
+    const char *csv_path;  // NULL = table on stdout only
+    double max_p99_ms;   // 0 = no limit; finish p99 on GL, render p99 in software
+    uint32_t max_draws;  // 0 = no limit
+    uint32_t fft_size;   // analysis FFT size and overlap percent
+    uint32_t overlap;
+    uint32_t spectrum_mode;  // ANALYSIS_MODE_*
+} bench_options_t;
+
+// Synthetic programme: a slow log sweep, two steady partials and some noise,
+// so the spectrum (and with it every column) keeps moving
+typedef struct {
+    double phase[3];
+    double time;
+    uint32_t seed;
+} bench_signal_t;
+
+static void bench_signal_fill(bench_signal_t *signal, float *out, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        double sweep_hz = 40.0 * pow(400.0, fmod(signal->time / 8.0, 1.0));
+        const double hz[3] = { sweep_hz, 220.0, 3520.0 };
+        double sample = 0.0;
+        for (int k = 0; k < 3; k++) {
+            signal->phase[k] += 2.0 * M_PI * hz[k] / BENCH_SAMPLE_RATE;
+            if (signal->phase[k] > 2.0 * M_PI) signal->phase[k] -= 2.0 * M_PI;
+            sample += (k == 0 ? 0.5 : 0.15) * sin(signal->phase[k]);
+        }
+        signal->seed = signal->seed * 1664525u + 1013904223u;
+        sample += 0.05 * (double)(int32_t)signal->seed / 2147483648.0;
+        out[i] = (float)sample;
+        signal->time += 1.0 / BENCH_SAMPLE_RATE;
+    }
+}
+
+typedef struct {
+    double render_p50, render_p90, render_p99, render_max;
+    double finish_p50, finish_p99;
+    uint32_t draw_calls;  // most in any frame
+    uint32_t vertices;
+    uint32_t quads;
+    double analysis_mean, analysis_max;  // worker pass time
+    float band_min_hz;                   // centre of the lowest band
+} bench_result_t;
+
+// One tier: warm up, then time frames that gui_update() says are due
+static bool bench_tier(const bench_options_t *options, int32_t tier, bench_result_t *result) {
+    gui_context_t *gui = (gui_context_t *)calloc(1, sizeof(gui_context_t));
+    if (!gui || !gui_create(gui, NULL, options->width, options->height)) {
+        free(gui);
+        return false;
+    }
+    if (options->software && !gui_set_backend(gui, GUI_BACKEND_SOFTWARE)) {
+        gui_destroy(gui);
+        free(gui);
+        return false;
+    }
+
+    // Uncapped frame rate; the tier is held whatever the frame time
+    gui_set_refresh_rate(gui, 1.0e6);
+    gui_set_quality_tier(gui, tier);
+    gui_set_analysis(gui, options->fft_size, options->overlap);
+    gui_set_spectrum_mode(gui, options->spectrum_mode);
+
+    double *render_ms = (double *)malloc(options->frames * sizeof(double));
+    double *finish_ms = (double *)malloc(options->frames * sizeof(double));
+    memset(result, 0, sizeof(bench_result_t));
+
+    bench_signal_t signal;
+    memset(&signal, 0, sizeof(signal));
+    signal.seed = 1;
+    float audio[BENCH_BLOCK];
+
+    for (uint32_t f = 0; f < BENCH_WARMUP_FRAMES + options->frames; f++) {
+        // A frame's worth of audio per frame; keep feeding until the scheduler has a frame due
+        do {
+            bench_signal_fill(&signal, audio, BENCH_BLOCK);
+        } while (!gui_update(gui, audio, BENCH_BLOCK, BENCH_SAMPLE_RATE));
+
+        uint64_t start = cpu_meter_now_ns();
+        gui_render(gui);
+        if (!options->software) glFinish();
+        gui_frame_presented(gui);
+        uint64_t finished = cpu_meter_now_ns();
+
+        // Frames run faster than real time: let the worker catch up, as it would
+        // between display refreshes, so the spectrum keeps moving
+        for (uint32_t wait = 0; wait < BENCH_DRAIN_WAIT_MS * 2 && audio_ring_available(&gui->analysis.ring) > 0; wait++) {
+            usleep(500);
+        }
+
+        if (f < BENCH_WARMUP_FRAMES) continue;
+        uint32_t sample = f - BENCH_WARMUP_FRAMES;
+        render_ms[sample] = gui->stats.frame_ms;
+        finish_ms[sample] = (finished - start) * 1.0e-6;
+        if (gui->stats.draw_calls > result->draw_calls) result->draw_calls = gui->stats.draw_calls;
+        if (gui->stats.vertices > result->vertices) result->vertices = gui->stats.vertices;
+        if (gui->stats.quads > result->quads) result->quads = gui->stats.quads;
+    }
+
+    bench_sort(render_ms, options->frames);
+    bench_sort(finish_ms, options->frames);
+    result->render_p50 = bench_percentile(render_ms, options->frames, 0.5);
+    result->render_p90 = bench_percentile(render_ms, options->frames, 0.9);
+    result->render_p99 = bench_percentile(render_ms, options->frames, 0.99);
+    result->render_max = render_ms[options->frames - 1];
+    result->finish_p50 = bench_percentile(finish_ms, options->frames, 0.5);
+    result->finish_p99 = bench_percentile(finish_ms, options->frames, 0.99);
+    analysis_worker_pass_stats(&gui->analysis, &result->analysis_mean, &result->analysis_max);
+    result->band_min_hz = gui->spectrum->band_min_hz;
+
+    free(render_ms);
+    free(finish_ms);
+    gui_destroy(gui);
+    free(gui);
+    return true;
+}
+
+// Overlay-only editors (the VST3 software path) draw over their own backdrop:
+// a second, unchanged overlay frame has to leave every row clean
+static bool bench_overlay_dirty_rows(const bench_options_t *options, uint32_t *dirty_rows) {
+    gui_context_t *gui = (gui_context_t *)calloc(1, sizeof(gui_context_t));
+    if (!gui || !gui_create(gui, NULL, options->width, options->height)) {
+        free(gui);
+        return false;
+    }
+    background_pass_t backdrop;
+    background_init(&backdrop, 1.0f);
+    bool ok = gui_set_backend(gui, GUI_BACKEND_SOFTWARE) &&
+              soft_framebuffer_set_background(gui_framebuffer(gui), background_fill, &backdrop);
+    if (ok) {
+        gui_render_overlay(gui);
+        gui_render_overlay(gui);
+        *dirty_rows = gui_framebuffer(gui)->dirty_count;
+    }
+    gui_destroy(gui);
+    free(gui);
+    return ok;
+}
+
+static bool bench_parse(int argc, char **argv, bench_options_t *options) {
+    options->frames = 600;
+    options->width = 800;
+    options->height = 600;
+    options->software = false;
+    options->csv_path = NULL;
+    options->max_p99_ms = 0.0;
+    options->max_draws = 0;
+    options->fft_size = ANALYSIS_DEFAULT_FFT_SIZE;
+    options->overlap = ANALYSIS_DEFAULT_OVERLAP;
+    options->spectrum_mode = ANALYSIS_MODE_LOG_FFT;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--software") == 0) {
+            options->software = true;
+        } else if (strcmp(arg, "--cqt") == 0) {
+            options->spectrum_mode = ANALYSIS_MODE_CONSTANT_Q;
+        } else if (strcmp(arg, "--csv") == 0 && value) {
+            options->csv_path = value;
+            i++;
+        } else if (strcmp(arg, "--frames") == 0 && value) {
+            options->frames = (uint32_t)atoi(value);
+            i++;
+        } else if (strcmp(arg, "--size") == 0 && value) {
+            if (sscanf(value, "%ux%u", &options->width, &options->height) != 2) return false;
+            i++;
+        } else if (strcmp(arg, "--max-p99") == 0 && value) {
+            options->max_p99_ms = atof(value);
+            i++;
+        } else if (strcmp(arg, "--max-draws") == 0 && value) {
+            options->max_draws = (uint32_t)atoi(value);
+            i++;
+        } else if (strcmp(arg, "--fft") == 0 && value) {
+            options->fft_size = (uint32_t)atoi(value);
+            i++;
+        } else if (strcmp(arg, "--overlap") == 0 && value) {
+            options->overlap = (uint32_t)atoi(value);
+            i++;
+        } else {
+            return false;
+        }
+    }
+    return options->frames >= 2 && options->width > 0 && options->height > 0;
+}
+
+int main(int argc, char **argv) {
+    bench_options_t options;
+    if (!bench_parse(argc, argv, &options)) {
+        fprintf(stderr, "usage: render_bench [--frames N] [--size WxH] [--software] [--csv FILE] "
+                        "[--max-p99 MS] [--max-draws N] [--fft N] [--overlap P] [--cqt]\n");
+        return 2;
+    }
+
+    // The software backend needs no context; GL runs offscreen at the editor size
+    if (!options.software && !bench_gl_init(options.width, options.height)) {
+        fprintf(stderr, "render_bench: no offscreen OpenGL context\n");
+        return 2;
+    }
+
+    // Machine-readable copy for tracking results across commits
+    const char *backend = options.software ? "software" : "opengl";
+    FILE *csv = NULL;
+    if (options.csv_path) {
+        csv = fopen(options.csv_path, "w");
+        if (!csv) {
+            fprintf(stderr, "render_bench: cannot write %s\n", options.csv_path);
+            return 2;
+        }
+        fprintf(csv, "backend,width,height,fft_size,overlap,spectrum_mode,tier,draw_calls,vertices,quads,"
+                     "render_p50_ms,render_p90_ms,render_p99_ms,render_max_ms,finish_p50_ms,finish_p99_ms,"
+                     "analysis_mean_ms,analysis_max_ms,band_min_hz\n");
+    }
+
+    // Constant-Q runs at least ANALYSIS_CQT_MIN_FFT_SIZE points whatever was asked for
+    const char *mode = options.spectrum_mode == ANALYSIS_MODE_CONSTANT_Q ? "constant-q" : "log-fft";
+    uint32_t fft_size = options.fft_size;
+    if (options.spectrum_mode == ANALYSIS_MODE_CONSTANT_Q && fft_size < ANALYSIS_CQT_MIN_FFT_SIZE) {
+        fft_size = ANALYSIS_CQT_MIN_FFT_SIZE;
+    }
+    printf("Renderer: %s, %ux%u, %u frames per tier, %s bands from a %u-point FFT at %u%% overlap\n",
+           options.software ? "software framebuffer" : bench_gl_renderer(),
+           options.width, options.height, options.frames, mode, fft_size, options.overlap);
+
+    bool pass = true;
+    for (int32_t tier = 0; tier < QUALITY_TIER_COUNT; tier++) {
+        bench_result_t result;
+        if (!bench_tier(&options, tier, &result)) {
+            fprintf(stderr, "render_bench: gui_create failed\n");
+            return 2;
+        }
+
+        printf("tier %d: %u draws, %u vertices, %u quads | render p50 %.3f p90 %.3f p99 %.3f max %.3f ms"
+               " | finish p50 %.3f p99 %.3f ms | analysis pass mean %.3f max %.3f ms, lowest band %.1f Hz\n",
+               tier, result.draw_calls, result.vertices, result.quads, result.render_p50, result.render_p90,
+               result.render_p99, result.render_max, result.finish_p50, result.finish_p99,
+               result.analysis_mean, result.analysis_max, result.band_min_hz);
+        if (csv) {
+            fprintf(csv, "%s,%u,%u,%u,%u,%s,%d,%u,%u,%u,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f\n", backend,
+                    options.width, options.height, fft_size, options.overlap, mode,
+                    tier, result.draw_calls, result.vertices, result.quads, result.render_p50, result.render_p90,
+                    result.render_p99, result.render_max, result.finish_p50, result.finish_p99,
+                    result.analysis_mean, result.analysis_max, result.band_min_hz);
+        }
+
+        // GL submission leaves out the rasteriser and driver, so GL runs gate on the
+        // time to glFinish; software frames are complete when gui_render returns
+        double gated_p99 = options.software ? result.render_p99 : result.finish_p99;
+        if (options.max_p99_ms > 0.0 && gated_p99 > options.max_p99_ms) {
+            fprintf(stderr, "render_bench: tier %d %s p99 %.3f ms exceeds %.3f ms\n",
+                    tier, options.software ? "render" : "finish", gated_p99, options.max_p99_ms);
+            pass = false;
+        }
+        if (options.max_draws > 0 && result.draw_calls > options.max_draws) {
+            fprintf(stderr, "render_bench: tier %d issues %u draw calls, limit %u\n",
+                    tier, result.draw_calls, options.max_draws);
+            pass = false;
+        }
+        if (options.spectrum_mode == ANALYSIS_MODE_CONSTANT_Q && !(result.band_min_hz > 0.0f &&
+                                                                   result.band_min_hz <= BENCH_CQT_MAX_FLOOR_HZ)) {
+            fprintf(stderr, "render_bench: tier %d constant-q bands start at %.1f Hz, above %.1f Hz\n",
+                    tier, result.band_min_hz, BENCH_CQT_MAX_FLOOR_HZ);
+            pass = false;
+        }
+    }
+
+    if (options.software) {
+        uint32_t dirty_rows = 0;
+        if (!bench_overlay_dirty_rows(&options, &dirty_rows)) {
+            fprintf(stderr, "render_bench: gui_create failed\n");
+            return 2;
+        }
+        printf("overlay: %u of %u rows dirty on an unchanged frame\n", dirty_rows, options.height);
+        if (dirty_rows > 0) {
+            fprintf(stderr, "render_bench: unchanged overlay frame redraws %u rows\n", dirty_rows);
+            pass = false;
+        }
+    }
+
+    if (csv) fclose(csv);
+    if (!options.software) bench_gl_shutdown();
+    return pass ? 0 : 1;
+}
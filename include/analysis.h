@@ -0,0 +1,179 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <atomic>
+#include "audio_ring.h"
+#include "fft.h"
+#include "band_map.h"
+#include "cqt.h"
+#include "decimator.h"
+
+// Spectrum analysis for the editor.
+// Audio is queued by the audio thread, analysed on a low-priority worker and
+// published as complete spectrum_analyzer_t snapshots through a lock-free
+// triple buffer, so the renderer never waits on analysis.
+// The worker estimates the spectrum with Welch's method: overlapping
+// Hann-windowed segments of a runtime-selectable FFT size are averaged, so
+// every queued sample contributes. Bands come either from log-spaced groups of
+// FFT bins or from a constant-Q transform of the same segments.
+// High host rates are first decimated by an integer factor, so analysis cost
+// and resolution stay the same from 44.1 kHz up to 384 kHz.
+
+// Display bins published in spectrum_analyzer_t (the lower half spans DC to Nyquist)
+#define MAX_FREQUENCY_BINS 256
+
+// Runtime FFT size range and defaults
+#define ANALYSIS_MIN_FFT_SIZE 256
+#define ANALYSIS_MAX_FFT_SIZE 16384
+#define ANALYSIS_DEFAULT_FFT_SIZE 2048
+#define ANALYSIS_MIN_OVERLAP 50
+#define ANALYSIS_MAX_OVERLAP 75
+#define ANALYSIS_DEFAULT_OVERLAP 75
+
+// Log-spaced display bands (one per matrix column) and the range they span
+#define ANALYSIS_MAX_BANDS 256
+#define ANALYSIS_DEFAULT_BANDS 64
+#define ANALYSIS_BAND_MIN_HZ 30.0f
+#define ANALYSIS_BAND_MAX_HZ 18000.0f
+#define ANALYSIS_DEFAULT_SAMPLE_RATE 48000
+
+// Lowest rate the decimator may reduce the host rate to (96 kHz -> 48, 176.4 kHz -> 44.1)
+#define ANALYSIS_MIN_RATE 44100.0
+
+// Band modes. Constant-Q bands are semitone-spaced; their lowest band is the
+// lowest note whose kernel fits the FFT size, so constant-Q analysis runs at
+// least ANALYSIS_CQT_MIN_FFT_SIZE points (lowest band G#1, 52 Hz, at 48 kHz,
+// where 2048 points would start at G#4, 415 Hz).
+#define ANALYSIS_MODE_LOG_FFT 0
+#define ANALYSIS_MODE_CONSTANT_Q 1
+#define ANALYSIS_CQT_BINS_PER_OCTAVE 12
+#define ANALYSIS_CQT_MIN_FFT_SIZE 16384
+
+// Upper bound on segments transformed per worker pass (older audio is skipped beyond it)
+#define ANALYSIS_MAX_SEGMENTS_PER_PASS 16
+
+// Audio queued between the processor and the worker (samples, about 340 ms at 192 kHz)
+#define ANALYSIS_RING_SIZE 65536
+
+// Audio queued between the decimator and the estimator (samples at the analysis rate)
+#define ANALYSIS_DECIMATED_RING_SIZE 16384
+
+// Worker wake-up interval when no audio is pending
+#define ANALYSIS_POLL_MS 4
+
+// Audio spectrum analyzer
+typedef struct {
+    float spectrum[MAX_FREQUENCY_BINS];
+    float peak_values[MAX_FREQUENCY_BINS];
+    uint32_t sample_count;
+
+    // Magnitude per log-spaced band, and the centre of the lowest one (Hz)
+    float bands[ANALYSIS_MAX_BANDS];
+    uint32_t band_count;
+    float band_min_hz;
+} spectrum_analyzer_t;
+
+// Welch estimator state (owned by the worker)
+typedef struct {
+    uint32_t fft_size;
+    uint32_t hop;
+    fft_plan_t plan;
+
+    float *window;      // fft_size, Hann
+    float *history;     // last fft_size samples
+    float *staging;     // samples collected towards the next hop
+    float *windowed;    // fft_size
+    float *re;          // fft_size / 2 + 1
+    float *im;
+    float *power_sum;   // accumulated |X|^2 since the last publish
+    float *band_power;  // ANALYSIS_MAX_BANDS, accumulated constant-Q |CQ|^2
+    uint32_t pending;
+    uint32_t segments;
+} spectrum_engine_t;
+
+// Analysis worker and its published snapshots
+typedef struct {
+    // Audio thread -> worker
+    audio_ring_t ring;
+
+    // Requested FFT size and overlap, sample rate and band count (any thread -> worker)
+    std::atomic<uint32_t> config;
+    std::atomic<uint32_t> sample_rate;
+    std::atomic<uint32_t> band_count;
+    std::atomic<uint32_t> mode;
+
+    // Cost of the transform part of passes that had audio (worker -> any thread)
+    std::atomic<uint64_t> pass_ns_total;
+    std::atomic<uint64_t> pass_ns_max;
+    std::atomic<uint32_t> pass_count;
+
+    // Worker-owned state
+    decimator_t decimator;
+    audio_ring_t decimated;
+    float decimate_input[DECIMATOR_BLOCK];
+    float decimate_output[DECIMATOR_BLOCK];
+    spectrum_engine_t engine;
+    band_map_t band_map;
+    cqt_kernel_t cqt;
+    uint32_t applied_config;
+    spectrum_analyzer_t working;
+    uint32_t write_index;
+
+    // Triple buffer: the worker fills one slot, the reader holds one, the third is
+    // exchanged through `shared` (slot index plus ANALYSIS_FRESH when newly published)
+    spectrum_analyzer_t slots[3];
+    std::atomic<uint32_t> shared;
+    uint32_t read_index;
+
+    pthread_t thread;
+    std::atomic<bool> running;
+    bool started;
+} analysis_worker_t;
+
+// Start the worker thread (false when the ring or thread could not be created)
+bool analysis_worker_start(analysis_worker_t *worker);
+
+// Stop the worker thread and free the ring
+void analysis_worker_stop(analysis_worker_t *worker);
+
+// Select FFT size (power of two, clamped to 256-16384) and segment overlap
+// (percent, clamped to 50-75). Applied by the worker before its next pass.
+void analysis_worker_configure(analysis_worker_t *worker, uint32_t fft_size, uint32_t overlap_percent);
+
+// Set the rate of the audio being pushed (Hz) and the number of display bands
+void analysis_worker_set_sample_rate(analysis_worker_t *worker, double sample_rate);
+void analysis_worker_set_band_count(analysis_worker_t *worker, uint32_t band_count);
+
+// Select how bands are computed (ANALYSIS_MODE_*); constant-Q raises the FFT
+// size to ANALYSIS_CQT_MIN_FFT_SIZE while selected
+void analysis_worker_set_mode(analysis_worker_t *worker, uint32_t mode);
+
+// Mean and worst time to transform and publish one pass (ms, 0 before the first)
+void analysis_worker_pass_stats(analysis_worker_t *worker, double *mean_ms, double *max_ms);
+
+// Queue audio for analysis (audio thread, wait-free, dropped when the worker falls behind)
+void analysis_worker_push(analysis_worker_t *worker, const float *audio_data, uint32_t frames);
+
+// Latest complete snapshot (single reader thread). The pointer stays valid
+// until the next call from the same reader.
+const spectrum_analyzer_t *analysis_worker_latest(analysis_worker_t *worker);
+
+// Audio spectrum analysis
+void spectrum_init(spectrum_analyzer_t *spectrum);
+void spectrum_update_peaks(spectrum_analyzer_t *spectrum);
+
+// Welch estimator (worker thread)
+bool spectrum_engine_init(spectrum_engine_t *engine, uint32_t fft_size, uint32_t overlap_percent);
+void spectrum_engine_destroy(spectrum_engine_t *engine);
+
+// Consume queued audio, transforming at most max_segments segments; returns segments done.
+// With a constant-Q kernel each segment's bands are accumulated as well.
+uint32_t spectrum_engine_feed(spectrum_engine_t *engine, audio_ring_t *ring, uint32_t max_segments,
+                              const cqt_kernel_t *cqt);
+
+// Write the averaged spectrum into the display bins and bands (from the constant-Q
+// kernel when given, otherwise through the band map), then restart the average
+void spectrum_engine_publish(spectrum_engine_t *engine, const band_map_t *band_map,
+                             const cqt_kernel_t *cqt, spectrum_analyzer_t *spectrum);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <atomic>
+
+// Wait-free single-producer/single-consumer sample ring.
+// The audio thread writes whole blocks with at most two memcpy calls and never
+// blocks: a block that does not fit is dropped. The GUI side drains it at
+// frame time.
+
+typedef struct {
+    float *samples;
+    uint32_t capacity;  // power of two
+    uint32_t mask;
+
+    // Free-running positions (wrap at 2^32), each written by one side only
+    alignas(64) std::atomic<uint32_t> write_pos;
+    alignas(64) std::atomic<uint32_t> read_pos;
+    alignas(64) std::atomic<uint32_t> dropped;  // blocks rejected because the reader fell behind
+} audio_ring_t;
+
+// Allocate the ring (capacity is rounded up to a power of two)
+bool audio_ring_init(audio_ring_t *ring, uint32_t capacity);
+
+// Free the ring
+void audio_ring_destroy(audio_ring_t *ring);
+
+// Producer: append a block, or drop it entirely when there is not enough room.
+// Returns false when the block was dropped.
+bool audio_ring_write(audio_ring_t *ring, const float *samples, uint32_t frames);
+
+// Consumer: samples ready to be read
+uint32_t audio_ring_available(audio_ring_t *ring);
+
+// Consumer: read up to max_frames samples, returns the number read
+uint32_t audio_ring_read(audio_ring_t *ring, float *samples, uint32_t max_frames);
+
+// Consumer: discard up to frames of the oldest samples, returns the number discarded
+uint32_t audio_ring_skip(audio_ring_t *ring, uint32_t frames);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gl_ext.h"
+
+// Procedural editor background.
+// The vertical blue gradient and the diagonal sine pattern are evaluated per
+// pixel by one fullscreen fragment pass: no texture, no upload and no
+// overdraw. background_fill() computes the same function on the CPU for the
+// software framebuffer, which keeps the result until the size changes.
+// Requires OpenGL 3.3; callers clear to a flat colour otherwise.
+
+typedef struct {
+    float pattern;         // 0 = gradient only, 1 = sine pattern only
+
+    // GL resources (created lazily with a current context)
+    bool gpu_ready;
+    bool gpu_failed;
+    GLuint program;
+    GLuint vao;
+    GLint u_pattern;
+
+    // Submitted by the last background_draw
+    uint32_t draw_calls;
+    uint32_t vertices;
+} background_pass_t;
+
+// Reset state (no GL calls)
+void background_init(background_pass_t *background, float pattern);
+
+// Release GL resources (context must be current if a draw happened)
+void background_destroy(background_pass_t *background);
+
+// Cover the current viewport; returns false when shaders are unavailable
+bool background_draw(background_pass_t *background);
+
+// Software twin of background_draw: width x height opaque RGBA pixels, top row
+// first (matches soft_fill_t, with the background_pass_t as user data)
+void background_fill(const void *background, uint8_t *pixels, uint32_t width, uint32_t height, uint32_t stride);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Sparse FFT-bin to display-band aggregation.
+// Bands are log-spaced between a low and high frequency. Each band is one
+// CSR row holding the bins it overlaps, weighted by the overlapping fraction.
+// Bands narrower than a bin interpolate between neighbouring bins instead of
+// coming out empty. The map is built once per (band count, FFT size, sample
+// rate), and band energies are then one sparse matrix-vector product per frame.
+
+typedef struct {
+    uint32_t band_count;
+    uint32_t fft_size;
+    double sample_rate;
+
+    uint32_t *row_start;  // band_count + 1 offsets into columns/weights
+    uint32_t *columns;    // FFT bin index per weight
+    float *weights;
+    uint32_t nonzeros;
+} band_map_t;
+
+// Build the map for bins 0 .. fft_size / 2 (false on allocation failure)
+bool band_map_build(band_map_t *map, uint32_t band_count, uint32_t fft_size, double sample_rate,
+                    float min_hz, float max_hz);
+
+// Free the map
+void band_map_destroy(band_map_t *map);
+
+// bands[b] = sum of weight * power[bin] over row b
+void band_map_apply(const band_map_t *map, const float *power, float *bands);
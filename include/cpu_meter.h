@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <atomic>
+
+// Per-block CPU load histogram.
+// The audio thread records how long each process()/run() call took as a
+// fraction of the block's real-time budget; the editor polls it lock-free.
+
+// Log-spaced buckets: 4 per octave from 2^-10 (0.1%) to 2^2 (400%) of budget
+#define CPU_METER_BUCKETS_PER_OCTAVE 4
+#define CPU_METER_MIN_OCTAVE -10
+#define CPU_METER_BUCKETS 48
+
+// Shared state (written only by the audio thread)
+typedef struct {
+    std::atomic<uint32_t> buckets[CPU_METER_BUCKETS];
+    std::atomic<uint32_t> max_load_bits;  // float bits, cleared by the reader
+    std::atomic<uint64_t> blocks;
+} cpu_meter_t;
+
+// Reader-side statistics (owned by the editor)
+typedef struct {
+    uint32_t last_buckets[CPU_METER_BUCKETS];
+    uint64_t last_blocks;
+
+    // Load as a fraction of the block budget (1.0 = full budget)
+    float p50;
+    float p99;
+    float max;
+} cpu_meter_stats_t;
+
+// Monotonic timestamp in nanoseconds (raw clock where available)
+uint64_t cpu_meter_now_ns(void);
+
+// Initialize meter
+void cpu_meter_init(cpu_meter_t *meter);
+
+// Record one block (audio thread, wait-free)
+void cpu_meter_record(cpu_meter_t *meter, uint64_t elapsed_ns, uint32_t frames, double sample_rate);
+
+// Initialize reader statistics
+void cpu_meter_stats_init(cpu_meter_stats_t *stats);
+
+// Update statistics from the blocks recorded since the last poll (any thread but the audio thread).
+// Returns false when no new blocks arrived and the previous values were kept.
+bool cpu_meter_poll(cpu_meter_t *meter, cpu_meter_stats_t *stats);
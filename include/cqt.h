@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fft.h"
+
+// Constant-Q transform through a sparse spectral kernel (Brown & Puckette).
+// Each band's temporal kernel (Hann-windowed complex exponential, Q cycles
+// long, centred in the frame) is transformed once and thresholded. A
+// constant-Q frame is then one sparse complex product with the FFT of the
+// frame, so the bands cost little more than the FFT itself. Frames are
+// expected to be Hann-windowed, as the analyzer's Welch segments are.
+// Bands are spaced bins_per_octave per octave, starting from the lowest
+// multiple of CQT_REFERENCE_HZ whose kernel fits into the FFT frame; bands
+// above the usable range stay empty.
+
+#define CQT_REFERENCE_HZ 32.703f       // C1
+#define CQT_KERNEL_THRESHOLD 0.01f     // relative to each band's peak kernel magnitude
+#define CQT_MAX_HZ_FRACTION 0.45f      // of the sample rate
+
+typedef struct {
+    uint32_t band_count;
+    uint32_t fft_size;
+    double sample_rate;
+    uint32_t bins_per_octave;
+    float min_hz;                // centre of band 0
+
+    uint32_t *row_start;         // band_count + 1 offsets
+    uint32_t *columns;           // FFT bin per kernel value
+    float *kernel_re;            // conjugated and scaled by 1/fft_size
+    float *kernel_im;
+    uint32_t nonzeros;
+} cqt_kernel_t;
+
+// Build the kernel for an FFT size and sample rate (false on allocation failure)
+bool cqt_kernel_build(cqt_kernel_t *kernel, uint32_t band_count, uint32_t bins_per_octave,
+                      uint32_t fft_size, double sample_rate);
+
+// Free the kernel
+void cqt_kernel_destroy(cqt_kernel_t *kernel);
+
+// Add |CQ[b]|^2 of one frame to band_power (re/im hold bins 0 .. fft_size / 2)
+void cqt_kernel_accumulate(const cqt_kernel_t *kernel, const float *re, const float *im, float *band_power);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Integer-factor FIR decimator for the analysis path.
+// A Blackman-windowed sinc (DECIMATOR_TAPS_PER_PHASE taps per phase, cutoff
+// at half the output rate) is evaluated only at the kept output samples, the
+// work a polyphase decimator does. The dot product runs over contiguous
+// history with independent lane sums so it vectorises. Aliasing folds only
+// into the top of the output band, above the displayed range.
+
+#define DECIMATOR_TAPS_PER_PHASE 32
+#define DECIMATOR_MAX_FACTOR 8
+#define DECIMATOR_BLOCK 1024
+
+typedef struct {
+    uint32_t factor;
+    uint32_t taps;           // factor * DECIMATOR_TAPS_PER_PHASE
+    float *coefficients;     // symmetric, so no reversal is needed
+    float *buffer;           // taps - 1 samples of history followed by one input block
+    uint32_t next;           // input offset of the next kept sample within the coming block
+} decimator_t;
+
+// Largest factor (up to DECIMATOR_MAX_FACTOR) that keeps the output rate at or above min_rate
+uint32_t decimator_factor_for_rate(double sample_rate, double min_rate);
+
+// Allocate for a factor of 1 .. DECIMATOR_MAX_FACTOR (false on allocation failure)
+bool decimator_init(decimator_t *decimator, uint32_t factor);
+
+// Free the filter
+void decimator_destroy(decimator_t *decimator);
+
+// Filter and decimate count samples; output must hold count / factor + 1 samples.
+// Returns the number of samples written.
+uint32_t decimator_process(decimator_t *decimator, const float *input, uint32_t count, float *output);
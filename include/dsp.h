@@ -18,6 +18,13 @@ typedef enum {
     FILTER_TYPE_HIGHSHELF = 6
 } filter_type_t;
 
+// Stereo routing of a two-channel filter bank
+typedef enum {
+    FILTER_CHANNEL_MODE_STEREO = 0,  // filter left and right
+    FILTER_CHANNEL_MODE_MID = 1,     // filter the mid (L+R) signal, pass the side
+    FILTER_CHANNEL_MODE_SIDE = 2     // filter the side (L-R) signal, pass the mid
+} filter_channel_mode_t;
+
 // Filter structure
 typedef struct {
     // Filter parameters
@@ -38,6 +45,35 @@ typedef struct {
     bool initialized;
 } filter_t;
 
+// Multichannel filter bank limits
+#define FILTER_MAX_CHANNELS 8
+#define FILTER_MAX_SECTIONS 4
+
+typedef struct filter_bank filter_bank_t;
+
+// Specialised block kernel (selected per filter type, channel count and section count)
+typedef void (*filter_kernel_fn)(filter_bank_t *bank, const float *const *inputs, float *const *outputs, uint32_t frames);
+
+// Multichannel filter bank: one set of coefficients, independent state per channel,
+// optionally cascaded into identical sections for steeper slopes
+struct filter_bank {
+    // Shared parameters and coefficients
+    filter_t filter;
+
+    uint32_t channels;
+    uint32_t sections;
+    filter_channel_mode_t channel_mode;  // only used with two channels
+
+    // Per-section, per-channel delays (channel is the fastest-moving index)
+    float x1[FILTER_MAX_SECTIONS][FILTER_MAX_CHANNELS];
+    float x2[FILTER_MAX_SECTIONS][FILTER_MAX_CHANNELS];
+    float y1[FILTER_MAX_SECTIONS][FILTER_MAX_CHANNELS];
+    float y2[FILTER_MAX_SECTIONS][FILTER_MAX_CHANNELS];
+
+    // Kernel chosen from the dispatch table when parameters change
+    filter_kernel_fn kernel;
+};
+
 // Initialize filter with parameters
 void filter_init(filter_t *filter, filter_type_t type, float cutoff_freq, float resonance, float gain, float sample_rate);
 
@@ -59,6 +95,25 @@ void filter_reset(filter_t *filter);
 // Calculate frequency response at given frequency (for visualization)
 void filter_get_frequency_response(filter_t *filter, float frequency, float *magnitude_db, float *phase_deg);
 
+// Initialize filter bank (channels 1..FILTER_MAX_CHANNELS, sections 1..FILTER_MAX_SECTIONS)
+void filter_bank_init(filter_bank_t *bank, filter_type_t type, float cutoff_freq, float resonance, float gain,
+                      float sample_rate, uint32_t channels, uint32_t sections);
+
+// Update filter bank parameters (recomputes coefficients and kernel only when something changed)
+void filter_bank_set_parameters(filter_bank_t *bank, filter_type_t type, float cutoff_freq, float resonance, float gain);
+
+// Set filter bank sample rate
+void filter_bank_set_sample_rate(filter_bank_t *bank, float sample_rate);
+
+// Select stereo or mid/side routing (two-channel banks; filter state restarts on a change)
+void filter_bank_set_channel_mode(filter_bank_t *bank, filter_channel_mode_t mode);
+
+// Process one block for every channel of the bank (in-place processing is allowed)
+void filter_bank_process(filter_bank_t *bank, const float *const *inputs, float *const *outputs, uint32_t frames);
+
+// Reset filter bank state
+void filter_bank_reset(filter_bank_t *bank);
+
 // Utility functions
 float freq_to_omega(float frequency, float sample_rate);
 float db_to_gain(float db);
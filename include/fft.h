@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Real-input FFT.
+// An N-point real transform is computed as an N/2-point complex FFT of the
+// even/odd samples packed as re/im, followed by a split post-processing step.
+// Bit-reversal and twiddle tables are built once per size; butterflies are
+// radix-4 (plus one radix-2 stage when log2(N/2) is odd) on split re/im
+// arrays so the inner loops vectorise. A plan is read-only after init and can
+// be shared between threads.
+
+#define FFT_MIN_SIZE 8
+#define FFT_MAX_SIZE 65536
+
+typedef struct {
+    uint32_t size;        // real input length N (power of two)
+    uint32_t half;        // complex length N/2
+    uint32_t half_log2;
+
+    uint32_t *bitrev;     // half entries
+    float *twiddle_re;    // radix-4 stage twiddles: per stage w^j, w^2j, w^3j blocks
+    float *twiddle_im;
+    float *post_re;       // e^(-2*pi*i*k/N) for k = 0 .. N/4
+    float *post_im;
+} fft_plan_t;
+
+// Build tables for an N-point real FFT (false for unsupported sizes or allocation failure)
+bool fft_plan_init(fft_plan_t *plan, uint32_t size);
+
+// Free the tables
+void fft_plan_destroy(fft_plan_t *plan);
+
+// Forward transform of plan->size real samples.
+// out_re/out_im receive bins 0 .. N/2 (N/2 + 1 values each) and double as scratch.
+void fft_real_forward(const fft_plan_t *plan, const float *input, float *out_re, float *out_im);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Editor frame pacing.
+// Hosts call into the editor on their own timers, often faster than the
+// display refreshes. The scheduler decides whether a frame is due, capping the
+// rate at the display refresh, and hands back the real elapsed time as the
+// animation step. Once the editor reports it has settled (silent input,
+// animation at rest), frames drop to FRAME_SCHEDULER_IDLE_HZ. A hidden editor
+// gets no frames at all.
+
+#define FRAME_SCHEDULER_DEFAULT_HZ 60.0
+#define FRAME_SCHEDULER_IDLE_HZ 4.0
+
+// Longest animation step handed out (after stalls, idle or hidden periods)
+#define FRAME_SCHEDULER_MAX_STEP 0.25f
+
+// A frame this close to its deadline counts as due (absorbs host timer jitter)
+#define FRAME_SCHEDULER_SLACK_NS 2000000ull
+
+typedef struct {
+    uint64_t active_interval_ns;  // 1 / display refresh
+    uint64_t last_frame_ns;       // 0 until the first frame
+    uint64_t next_frame_ns;
+    bool visible;
+    bool idle;
+} frame_scheduler_t;
+
+// Initialize for a display refresh rate (Hz)
+void frame_scheduler_init(frame_scheduler_t *scheduler, double refresh_hz);
+
+// Change the display refresh rate (Hz)
+void frame_scheduler_set_refresh_rate(frame_scheduler_t *scheduler, double refresh_hz);
+
+// Stop (false) or resume (true) frames; resuming starts a fresh timeline
+void frame_scheduler_set_visible(frame_scheduler_t *scheduler, bool visible);
+
+// Switch between the display rate and the idle rate
+void frame_scheduler_set_idle(frame_scheduler_t *scheduler, bool idle);
+
+// True when a frame is due at now_ns; delta_time receives the seconds since the last frame
+bool frame_scheduler_begin(frame_scheduler_t *scheduler, uint64_t now_ns, float *delta_time);
+
+// Milliseconds until the next frame is due at now_ns (at least 1), for editors that sleep on a timer
+uint32_t frame_scheduler_wait_ms(const frame_scheduler_t *scheduler, uint64_t now_ns);
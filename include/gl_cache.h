@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gl_ext.h"
+
+// Process-wide cache of GL programs and static textures.
+// Every editor instance asks for the same shaders and atlases; the cache
+// creates each one once per share group (contexts that share objects) and
+// hands out reference counted names. Editors in a group that was joined with
+// gl_cache_join_context() also keep unreferenced objects until the group is
+// left, so reopening an editor costs no GL work at all. Pixel data for static
+// textures is built once per process and kept, so even an editor in an
+// unrelated context only pays for the upload.
+//
+// Containers (VAOs, framebuffers) are never shared between contexts and stay
+// per instance. Calls must be made with the editor's context current; contexts
+// the cache cannot identify get uncached objects that are simply deleted on
+// release.
+
+#define GL_CACHE_MAX_CONTEXTS 64
+
+// Objects one share group can hold (an editor uses about seven), so every
+// group that fits in the context table also fits in the entry table
+#define GL_CACHE_GROUP_ENTRIES 16
+#define GL_CACHE_MAX_ENTRIES (GL_CACHE_GROUP_ENTRIES * GL_CACHE_MAX_CONTEXTS)
+
+// Distinct static textures built per process
+#define GL_CACHE_MAX_PIXELS 64
+
+// Fill width * height * channels bytes (row 0 first)
+typedef void (*gl_cache_fill_t)(uint8_t *pixels, uint32_t width, uint32_t height, uint32_t channels);
+
+typedef struct {
+    const char *key;         // identifies the texture (static string)
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;       // bytes per pixel of the data
+    GLint internal_format;
+    GLenum format;
+    GLint filter;            // min and mag filter
+    GLint wrap;
+    const uint8_t *pixels;   // fixed data, or NULL to build it with fill
+    gl_cache_fill_t fill;
+} gl_cache_texture_desc_t;
+
+// Native handle of the current context (GLXContext, HGLRC or CGLContextObj; NULL if none)
+void *gl_cache_current_context(void);
+
+// A context of the longest-lived group, to pass as the share context when an
+// editor creates its own (NULL when no editor context exists yet)
+void *gl_cache_share_context(void);
+
+// Register a context created to share objects with share_context (NULL starts a
+// new group). Joined groups keep unreferenced objects until their last context leaves.
+bool gl_cache_join_context(void *context, void *share_context);
+
+// Forget a context before it is destroyed; the group's objects are dropped with
+// its last context (and deleted if that context is current)
+void gl_cache_leave_context(void *context);
+
+// Shared program for a key, compiled on first use (0 on failure)
+GLuint gl_cache_acquire_program(const char *key, const char *vertex_source, const char *fragment_source);
+
+// Shared texture for a description, created on first use (0 on failure)
+GLuint gl_cache_acquire_texture(const gl_cache_texture_desc_t *desc);
+
+// Drop a reference taken by gl_cache_acquire_program / gl_cache_acquire_texture
+void gl_cache_release_program(GLuint program);
+void gl_cache_release_texture(GLuint texture);
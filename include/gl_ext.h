@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdbool.h>
+
+// OpenGL 3.3 core entry points used by the shader-based renderers.
+// On Apple the functions are exported directly by the framework; elsewhere
+// they are resolved at runtime with gl_ext_load() once a context is current.
+
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+#define GL_EXT_FUNCTION_LIST(X) \
+    X(PFNGLCREATESHADERPROC, glCreateShader) \
+    X(PFNGLSHADERSOURCEPROC, glShaderSource) \
+    X(PFNGLCOMPILESHADERPROC, glCompileShader) \
+    X(PFNGLGETSHADERIVPROC, glGetShaderiv) \
+    X(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog) \
+    X(PFNGLDELETESHADERPROC, glDeleteShader) \
+    X(PFNGLCREATEPROGRAMPROC, glCreateProgram) \
+    X(PFNGLATTACHSHADERPROC, glAttachShader) \
+    X(PFNGLLINKPROGRAMPROC, glLinkProgram) \
+    X(PFNGLGETPROGRAMIVPROC, glGetProgramiv) \
+    X(PFNGLGETPROGRAMINFOLOGPROC, glGetProgramInfoLog) \
+    X(PFNGLDELETEPROGRAMPROC, glDeleteProgram) \
+    X(PFNGLUSEPROGRAMPROC, glUseProgram) \
+    X(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation) \
+    X(PFNGLUNIFORM1IPROC, glUniform1i) \
+    X(PFNGLUNIFORM1FPROC, glUniform1f) \
+    X(PFNGLUNIFORM2FPROC, glUniform2f) \
+    X(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays) \
+    X(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray) \
+    X(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays) \
+    X(PFNGLGENBUFFERSPROC, glGenBuffers) \
+    X(PFNGLBINDBUFFERPROC, glBindBuffer) \
+    X(PFNGLBUFFERDATAPROC, glBufferData) \
+    X(PFNGLBUFFERSUBDATAPROC, glBufferSubData) \
+    X(PFNGLDELETEBUFFERSPROC, glDeleteBuffers) \
+    X(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray) \
+    X(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer) \
+    X(PFNGLVERTEXATTRIBDIVISORPROC, glVertexAttribDivisor) \
+    X(PFNGLDRAWARRAYSINSTANCEDPROC, glDrawArraysInstanced) \
+    X(PFNGLACTIVETEXTUREPROC, glActiveTexture) \
+    X(PFNGLGENFRAMEBUFFERSPROC, glGenFramebuffers) \
+    X(PFNGLBINDFRAMEBUFFERPROC, glBindFramebuffer) \
+    X(PFNGLFRAMEBUFFERTEXTURE2DPROC, glFramebufferTexture2D) \
+    X(PFNGLCHECKFRAMEBUFFERSTATUSPROC, glCheckFramebufferStatus) \
+    X(PFNGLDELETEFRAMEBUFFERSPROC, glDeleteFramebuffers) \
+    X(PFNGLBLITFRAMEBUFFERPROC, glBlitFramebuffer)
+
+#define GL_EXT_DECLARE(type, name) extern type mf_##name;
+GL_EXT_FUNCTION_LIST(GL_EXT_DECLARE)
+#undef GL_EXT_DECLARE
+
+#define glCreateShader mf_glCreateShader
+#define glShaderSource mf_glShaderSource
+#define glCompileShader mf_glCompileShader
+#define glGetShaderiv mf_glGetShaderiv
+#define glGetShaderInfoLog mf_glGetShaderInfoLog
+#define glDeleteShader mf_glDeleteShader
+#define glCreateProgram mf_glCreateProgram
+#define glAttachShader mf_glAttachShader
+#define glLinkProgram mf_glLinkProgram
+#define glGetProgramiv mf_glGetProgramiv
+#define glGetProgramInfoLog mf_glGetProgramInfoLog
+#define glDeleteProgram mf_glDeleteProgram
+#define glUseProgram mf_glUseProgram
+#define glGetUniformLocation mf_glGetUniformLocation
+#define glUniform1i mf_glUniform1i
+#define glUniform1f mf_glUniform1f
+#define glUniform2f mf_glUniform2f
+#define glGenVertexArrays mf_glGenVertexArrays
+#define glBindVertexArray mf_glBindVertexArray
+#define glDeleteVertexArrays mf_glDeleteVertexArrays
+#define glGenBuffers mf_glGenBuffers
+#define glBindBuffer mf_glBindBuffer
+#define glBufferData mf_glBufferData
+#define glBufferSubData mf_glBufferSubData
+#define glDeleteBuffers mf_glDeleteBuffers
+#define glEnableVertexAttribArray mf_glEnableVertexAttribArray
+#define glVertexAttribPointer mf_glVertexAttribPointer
+#define glVertexAttribDivisor mf_glVertexAttribDivisor
+#define glDrawArraysInstanced mf_glDrawArraysInstanced
+#define glActiveTexture mf_glActiveTexture
+#define glGenFramebuffers mf_glGenFramebuffers
+#define glBindFramebuffer mf_glBindFramebuffer
+#define glFramebufferTexture2D mf_glFramebufferTexture2D
+#define glCheckFramebufferStatus mf_glCheckFramebufferStatus
+#define glDeleteFramebuffers mf_glDeleteFramebuffers
+#define glBlitFramebuffer mf_glBlitFramebuffer
+#endif
+
+// Resolve entry points for the current context.
+// Returns false when the context is older than OpenGL 3.3 or an entry point is missing.
+bool gl_ext_load(void);
+
+// Compile and link a vertex/fragment program (0 on failure, log printed to stderr)
+GLuint gl_ext_create_program(const char *vertex_source, const char *fragment_source);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "soft_render.h"
+
+// Editor child window with its own OpenGL context.
+// The window is created inside the host's parent window (X11 Window or HWND).
+// Its context is created with gl_cache_share_context() as the share context
+// and joined to the cache, so every editor in the process compiles its shaders
+// and uploads its atlas once. When no usable context can be created the window
+// stays and takes software frames instead (gl_window_present).
+//
+// All calls belong to the editor's UI thread. macOS editors need an
+// NSOpenGLView, which this C layer does not create; there gl_window_create
+// fails and hosts with a toolkit of their own draw the software frame.
+
+typedef struct {
+    void *display;          // X11 Display shared by every editor window (NULL elsewhere)
+    uintptr_t window;       // X11 Window or HWND
+    void *device;           // HDC on Windows
+    void *context;          // GLXContext or HGLRC; NULL on the software path
+    uint32_t width;
+    uint32_t height;
+
+    // Software presents: frame converted to the window's pixel layout
+    uint8_t *scratch;
+    uint32_t scratch_size;
+} gl_window_t;
+
+// Create a width x height child of parent and try to give it a shared GL context.
+// False when not even the window could be created.
+bool gl_window_create(gl_window_t *window, void *parent, uint32_t width, uint32_t height);
+
+// True when the window has a GL context (otherwise draw in software and present)
+bool gl_window_has_gl(const gl_window_t *window);
+
+// Native handle of the child window (the widget handed to LV2 hosts)
+void *gl_window_handle(const gl_window_t *window);
+
+// Make the window's context current (false on the software path)
+bool gl_window_make_current(gl_window_t *window);
+
+// Show the frame rendered with the context current
+void gl_window_swap(gl_window_t *window);
+
+// Show the dirty rows of a software frame
+void gl_window_present(gl_window_t *window, const soft_framebuffer_t *frame);
+
+// Follow the editor size
+void gl_window_resize(gl_window_t *window, uint32_t width, uint32_t height);
+
+// Leave the GL cache and destroy the context and window. Release the editor's
+// GL objects first, with gl_window_make_current.
+void gl_window_destroy(gl_window_t *window);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gl_ext.h"
+
+// Post-process glow.
+// The frame is rendered once into an offscreen texture; bright parts are
+// downsampled to quarter resolution, blurred with a separable Gaussian and
+// added back while compositing. The cost depends only on the view size,
+// not on how many characters are lit. Requires OpenGL 3.3.
+
+#define GLOW_DOWNSAMPLE 4
+
+typedef struct {
+    // GL resources (created lazily with a current context)
+    bool gpu_ready;
+    bool gpu_failed;
+    GLuint bright_program;
+    GLuint blur_program;
+    GLuint composite_program;
+    GLuint vao;
+    GLint u_blur_direction;
+    GLint u_composite_intensity;
+
+    // Full resolution scene and two quarter resolution ping-pong targets
+    GLuint framebuffers[3];
+    GLuint textures[3];
+    uint32_t width;
+    uint32_t height;
+
+    // Framebuffer and viewport to composite into (saved by glow_begin)
+    GLint target_framebuffer;
+    GLint target_viewport[4];
+
+    float intensity;
+
+    // Submitted since glow_begin
+    uint32_t draw_calls;
+    uint32_t vertices;
+} glow_pass_t;
+
+// Reset state (no GL calls)
+void glow_init(glow_pass_t *glow);
+
+// Release GL resources (context must be current if glow_begin succeeded)
+void glow_destroy(glow_pass_t *glow);
+
+// Redirect rendering into the offscreen scene (resized on demand).
+// Returns false when post-processing is unavailable; the caller then draws directly.
+bool glow_begin(glow_pass_t *glow, uint32_t width, uint32_t height);
+
+// Blur the scene's highlights and composite scene + glow into the saved target
+void glow_end(glow_pass_t *glow);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// Glyph atlas for the matrix character set.
+// A built-in 5x7 pixel font is rasterised once into an 8-bit coverage image;
+// each glyph (and a solid cell used for plain quads) is then just a UV rectangle.
+
+#define GLYPH_ATLAS_CELL 8
+#define GLYPH_ATLAS_COLUMNS 16
+#define GLYPH_ATLAS_ROWS 8
+#define GLYPH_ATLAS_WIDTH (GLYPH_ATLAS_CELL * GLYPH_ATLAS_COLUMNS)
+#define GLYPH_ATLAS_HEIGHT (GLYPH_ATLAS_CELL * GLYPH_ATLAS_ROWS)
+
+// UV rectangle: (u0, v0) maps to the quad's bottom-left corner, (u1, v1) to its top-right
+typedef struct {
+    float u0, v0, u1, v1;
+} glyph_uv_t;
+
+// Coverage image (GLYPH_ATLAS_WIDTH x GLYPH_ATLAS_HEIGHT, row 0 first), built on first use
+const uint8_t *glyph_atlas_pixels(void);
+
+// UV rectangle of a character (characters outside the font map to the solid cell)
+glyph_uv_t glyph_atlas_lookup(char c);
+
+// UV rectangle of the fully covered cell used for untextured quads
+glyph_uv_t glyph_atlas_solid(void);
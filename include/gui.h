@@ -9,31 +9,75 @@
 #include <pthread.h>
 #include <GL/gl.h>
 #include <GL/glu.h>
+#include "cpu_meter.h"
+#include "level_meter.h"
+#include "loudness.h"
+#include "quad_batch.h"
+#include "glow.h"
+#include "background.h"
+#include "spectrogram.h"
+#include "analysis.h"
+#include "frame_scheduler.h"
+#include "quality.h"
+#include "rng.h"
+#include "soft_render.h"
 
-// Matrix visual effect configuration
-#define MATRIX_WIDTH 64
-#define MATRIX_HEIGHT 32
-#define MAX_FREQUENCY_BINS 256
+// Matrix grid: one character cell per MATRIX_CELL_WIDTH x MATRIX_CELL_HEIGHT logical
+// pixels (an 800x600 editor at scale 1 is 64x32), derived again on every resize
+#define MATRIX_CELL_WIDTH 12.5f
+#define MATRIX_CELL_HEIGHT 18.75f
+#define MATRIX_MIN_WIDTH 16
+#define MATRIX_MIN_HEIGHT 8
+#define MATRIX_MAX_WIDTH 1024
+#define MATRIX_MAX_HEIGHT 512
+
+// Rendering backends behind gui_render()
+#define GUI_BACKEND_OPENGL 0
+#define GUI_BACKEND_SOFTWARE 1   // RGBA8 pixel buffer, no GL context needed
+
+// Editor size limits in pixels (hosts are asked to keep resizes within them)
+#define GUI_MIN_WIDTH 400
+#define GUI_MIN_HEIGHT 300
+#define GUI_MAX_WIDTH 7680
+#define GUI_MAX_HEIGHT 4320
+
+// Column brightness below which the matrix counts as at rest (lets the editor idle)
+#define MATRIX_SETTLED_BRIGHTNESS 0.004f
+
+// Bottom of the output level and loudness meters (dBFS / LUFS)
+#define GUI_METER_FLOOR_DB -60.0f
+
+// True peak above which the loudness bar turns amber (dBTP)
+#define GUI_TRUE_PEAK_WARNING_DB -1.0f
 
 // Matrix character set (extended ASCII + numbers)
 static const char MATRIX_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789@#$%^&*()_+-=[]{}|;:',.<>?/";
+#define MATRIX_CHAR_COUNT (sizeof(MATRIX_CHARS) - 1)
 
-// Matrix column structure
+// Matrix column state, one array per field so the update loop vectorises.
+// Column i is drawn at x = i. All arrays share one block that is only
+// reallocated when the grid width changes.
 typedef struct {
-    int x;
-    float y;
-    float speed;
-    char current_char;
-    float brightness;
-    float target_brightness;
-} matrix_column_t;
+    float *y;
+    float *speed;
+    float *brightness;
+    float *target_brightness;
+    uint32_t *symbol;  // index into MATRIX_CHARS
+    uint32_t *rng;     // per-column xorshift state
+    float *level;      // per-frame scratch: each column's band level
+    uint32_t *random;  // per-frame scratch: each column's draw
+    uint32_t count;
+    void *block;
+} matrix_columns_t;
 
-// Audio spectrum analyzer
+// What the last gui_render submitted
 typedef struct {
-    float spectrum[MAX_FREQUENCY_BINS];
-    float peak_values[MAX_FREQUENCY_BINS];
-    uint32_t sample_count;
-} spectrum_analyzer_t;
+    uint32_t draw_calls;
+    uint32_t vertices;
+    uint32_t quads;
+    float frame_ms;    // CPU time submitting the frame
+    float present_ms;  // gui_render to gui_frame_presented (what the quality governor sees)
+} gui_render_stats_t;
 
 // GUI context
 typedef struct {
@@ -42,15 +86,55 @@ typedef struct {
     uint32_t width;
     uint32_t height;
     
+    // Grid derived from the pixel size, scale factor and cell size
+    uint32_t grid_width;
+    uint32_t grid_height;
+    float scale_factor;
+    float cell_width;
+    float cell_height;
+    
     // Matrix visualization
-    matrix_column_t columns[MATRIX_WIDTH];
+    matrix_columns_t columns;
     float time_accumulator;
     
-    // Audio analysis
-    spectrum_analyzer_t spectrum;
+    // Per-frame quad stream submitted with one draw call
+    quad_batch_t batch;
+    
+    // Offscreen bloom applied to the whole matrix layer
+    glow_pass_t glow;
+    background_pass_t background;
+    spectrogram_t spectrogram;
+    
+    // Backend, and the pixel buffer the software backend draws into
+    uint32_t backend;
+    soft_framebuffer_t framebuffer;
+    
+    // Audio analysis (worker thread) and the snapshot used for the current frame
+    analysis_worker_t analysis;
+    const spectrum_analyzer_t *spectrum;
+    
+    // Frame pacing (display-rate cap, idle rate when settled, stopped when hidden)
+    frame_scheduler_t scheduler;
+    float frame_step;  // seconds of animation the last frame advanced by
+    
+    // Visual quality tier chosen from measured render time
+    quality_governor_t quality;
+    gui_render_stats_t stats;
+    uint64_t frame_start_ns;  // start of a gui_render not yet presented (0 when none)
+    
+    // Processor CPU load (owned by the processor, may be NULL)
+    cpu_meter_t *cpu_meter;
+    cpu_meter_stats_t cpu_stats;
+    
+    // Processor output levels (owned by the processor, may be NULL)
+    level_meter_t *level_meter;
+    level_meter_stats_t level_stats;
+    
+    // Processor output loudness (owned by the processor, may be NULL)
+    const loudness_meter_t *loudness_meter;
+    loudness_values_t loudness;
     
     // Threading
-    pthread_mutex_t mutex;
     bool running;
     
     // Plugin reference
@@ -60,22 +144,36 @@ typedef struct {
 // Function declarations
 bool gui_create(gui_context_t *gui, const clap_plugin_t *plugin, uint32_t width, uint32_t height);
 void gui_destroy(gui_context_t *gui);
-void gui_update(gui_context_t *gui, const float *audio_buffer, uint32_t frames, double sample_rate);
+bool gui_update(gui_context_t *gui, const float *audio_buffer, uint32_t frames, double sample_rate);
 void gui_render(gui_context_t *gui);
+void gui_frame_presented(gui_context_t *gui);
+bool gui_resize(gui_context_t *gui, uint32_t width, uint32_t height);
+void gui_constrain_size(int32_t *width, int32_t *height);
+bool gui_set_scale_factor(gui_context_t *gui, float scale_factor);
+bool gui_set_cell_size(gui_context_t *gui, float cell_width, float cell_height);
+void gui_set_quality_tier(gui_context_t *gui, int32_t tier);
+void gui_set_analysis(gui_context_t *gui, uint32_t fft_size, uint32_t overlap_percent);
+void gui_set_spectrum_mode(gui_context_t *gui, uint32_t mode);
+bool gui_set_backend(gui_context_t *gui, uint32_t backend);
+soft_framebuffer_t *gui_framebuffer(gui_context_t *gui);
+void gui_set_visible(gui_context_t *gui, bool visible);
+void gui_set_refresh_rate(gui_context_t *gui, double refresh_hz);
+uint32_t gui_frame_wait_ms(const gui_context_t *gui);
 void gui_handle_audio_data(gui_context_t *gui, const float *audio_data, uint32_t frames);
+void gui_set_cpu_meter(gui_context_t *gui, cpu_meter_t *meter);
+void gui_set_level_meter(gui_context_t *gui, level_meter_t *meter);
+void gui_set_loudness_meter(gui_context_t *gui, const loudness_meter_t *meter);
+void gui_render_overlay(gui_context_t *gui);
 
 // Matrix visualization functions
-void matrix_init(gui_context_t *gui);
+bool matrix_init(gui_context_t *gui);
+bool matrix_resize(gui_context_t *gui, uint32_t grid_width, uint32_t grid_height);
+void matrix_destroy(gui_context_t *gui);
 void matrix_update(gui_context_t *gui, float delta_time);
 void matrix_render(gui_context_t *gui);
 
-// Audio spectrum analysis
-void spectrum_init(spectrum_analyzer_t *spectrum);
-void spectrum_analyze(spectrum_analyzer_t *spectrum, const float *audio_data, uint32_t frames);
-void spectrum_update_peaks(spectrum_analyzer_t *spectrum);
-
 // OpenGL rendering utilities
 void opengl_init();
 void opengl_setup_projection(uint32_t width, uint32_t height);
-void opengl_draw_character(float x, float y, float size, char c, float brightness);
+void opengl_draw_character(quad_batch_t *batch, float x, float y, float size, char c, float brightness);
 void opengl_clear_screen();
\ No newline at end of file
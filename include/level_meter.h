@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <atomic>
+
+// Output level meter.
+// The audio thread makes one pass over each block that yields both channels'
+// peak and sum of squares and their cross product, folds the block into
+// exponentially integrated mean squares and mean product, and publishes them
+// through relaxed atomics. The window is fixed in audio time, however often
+// the editor polls. The editor reads them lock-free and turns them into peak,
+// RMS and stereo correlation, without touching the spectrum analysis.
+
+#define LEVEL_METER_CHANNELS 2
+
+// RMS and correlation ballistics: integration time constant (seconds)
+#define LEVEL_METER_INTEGRATION_S 0.3
+
+// Display ballistics: held peaks fall at this rate
+#define LEVEL_METER_PEAK_FALL_DB_PER_S 20.0f
+
+// Shared state (written only by the audio thread)
+typedef struct {
+    // Integrated values, published under an even/odd sequence so a reader sees
+    // the frame count and the means of the same block
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint64_t> frames;
+    std::atomic<uint64_t> mean_square_bits[LEVEL_METER_CHANNELS];  // double bits
+    std::atomic<uint64_t> mean_product_bits;                       // double bits
+
+    // Largest |sample| per channel since the reader's last poll (float bits, cleared by the reader)
+    std::atomic<uint32_t> peak_bits[LEVEL_METER_CHANNELS];
+
+    // Writer-side state
+    uint64_t total_frames;
+    double mean_square[LEVEL_METER_CHANNELS];
+    double mean_product;
+} level_meter_t;
+
+// Reader-side statistics (owned by the editor)
+typedef struct {
+    uint64_t last_frames;
+    uint64_t last_poll_ns;
+
+    // Linear levels (1.0 = full scale)
+    float peak[LEVEL_METER_CHANNELS];   // held, falling at LEVEL_METER_PEAK_FALL_DB_PER_S
+    float rms[LEVEL_METER_CHANNELS];    // integrated over LEVEL_METER_INTEGRATION_S
+    float correlation;                  // -1 (out of phase) to 1 (mono); 0 when silent
+} level_meter_stats_t;
+
+// Initialize meter
+void level_meter_init(level_meter_t *meter);
+
+// Meter one block (audio thread, wait-free); a mono block is metered as both channels
+void level_meter_record(level_meter_t *meter, const float *const *channels, uint32_t channel_count, uint32_t frames,
+                        double sample_rate);
+
+// Initialize reader statistics
+void level_meter_stats_init(level_meter_stats_t *stats);
+
+// Update statistics from the latest integrated values (any thread but the audio thread).
+// Returns false when no new blocks arrived; held peaks still fall.
+bool level_meter_poll(level_meter_t *meter, level_meter_stats_t *stats);
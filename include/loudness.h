@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <atomic>
+#include "dsp.h"
+
+// EBU R128 / ITU-R BS.1770 loudness and true-peak meter.
+// Runs on the audio thread in fixed memory: K-weighting is the existing
+// high-shelf and high-pass filter banks in cascade, energies are gathered in
+// 100 ms steps (momentary = last 4, short-term = last 30), and gated integrated
+// loudness comes from a histogram of 400 ms block loudness in 0.1 LU bins.
+// True peak is the largest sample of a 4x polyphase oversampled signal.
+// Readers pick up the latest values through relaxed atomics.
+
+#define LOUDNESS_CHANNELS 2
+#define LOUDNESS_CHUNK 256              // frames K-weighted per pass through the scratch buffers
+
+// Gating blocks built from 100 ms steps
+#define LOUDNESS_MOMENTARY_STEPS 4      // 400 ms
+#define LOUDNESS_SHORT_TERM_STEPS 30    // 3 s
+
+// Histogram over [LOUDNESS_ABSOLUTE_GATE, LOUDNESS_HISTOGRAM_TOP) LUFS
+#define LOUDNESS_ABSOLUTE_GATE -70.0f
+#define LOUDNESS_RELATIVE_GATE -10.0f   // LU below the absolute-gated loudness
+#define LOUDNESS_HISTOGRAM_TOP 5.0f
+#define LOUDNESS_HISTOGRAM_BINS 750     // 0.1 LU each
+
+// True-peak oversampler
+#define LOUDNESS_OVERSAMPLE 4
+#define LOUDNESS_TRUE_PEAK_TAPS 12      // per phase (48-tap prototype)
+
+// Reported for silence and before the first block completes
+#define LOUDNESS_FLOOR -120.0f
+
+// Meter state (written only by the audio thread, apart from the published values)
+typedef struct {
+    // Published values (float bits)
+    std::atomic<uint32_t> momentary_bits;    // LUFS over the last 400 ms
+    std::atomic<uint32_t> short_term_bits;   // LUFS over the last 3 s
+    std::atomic<uint32_t> integrated_bits;   // gated LUFS since reset
+    std::atomic<uint32_t> true_peak_bits;    // dBTP, maximum since reset
+
+    uint32_t channels;
+    float sample_rate;
+
+    // K-weighting: pre-filter (high shelf) then RLB high-pass, into scratch buffers
+    filter_bank_t shelf;
+    filter_bank_t highpass;
+    float weighted[LOUDNESS_CHANNELS][LOUDNESS_CHUNK];
+
+    // Current 100 ms step and the ring of completed step energies (sum of squares over channels)
+    uint32_t step_frames;
+    uint32_t step_position;
+    double step_energy;
+    double steps[LOUDNESS_SHORT_TERM_STEPS];
+    uint32_t step_head;
+    uint32_t step_count;
+
+    // Blocks above the absolute gate: count and summed mean-square energy per bin
+    uint32_t histogram_count[LOUDNESS_HISTOGRAM_BINS];
+    double histogram_energy[LOUDNESS_HISTOGRAM_BINS];
+
+    // Polyphase kernel and per-channel input history (previous taps, then the chunk)
+    float true_peak_kernel[LOUDNESS_OVERSAMPLE][LOUDNESS_TRUE_PEAK_TAPS];
+    float true_peak_history[LOUDNESS_CHANNELS][LOUDNESS_TRUE_PEAK_TAPS - 1 + LOUDNESS_CHUNK];
+    float true_peak;                         // linear
+} loudness_meter_t;
+
+// Latest values for display
+typedef struct {
+    float momentary;
+    float short_term;
+    float integrated;
+    float true_peak;
+} loudness_values_t;
+
+// Initialize meter for 1 or 2 channels (also resets all measurements)
+void loudness_meter_init(loudness_meter_t *meter, float sample_rate, uint32_t channels);
+
+// Restart integrated loudness, the windows and the true-peak maximum (audio thread or inactive)
+void loudness_meter_reset(loudness_meter_t *meter);
+
+// Meter one block (audio thread, no allocation); channels beyond the meter's count are ignored
+void loudness_meter_process(loudness_meter_t *meter, const float *const *channels, uint32_t frames);
+
+// Read the latest published values (any thread)
+void loudness_meter_read(const loudness_meter_t *meter, loudness_values_t *values);
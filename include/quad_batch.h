@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gl_ext.h"
+#include "glyph_atlas.h"
+
+// Per-frame batch of axis-aligned quads, either solid or textured with a glyph.
+// Everything the editor draws is pushed here and submitted with a single
+// instanced draw call on OpenGL 3.3 core; older contexts fall back to one
+// immediate-mode GL_QUADS batch.
+
+// One quad instance (matches the vertex attribute layout)
+typedef struct {
+    float x, y, width, height;
+    float r, g, b, a;
+    glyph_uv_t uv;  // atlas rectangle (solid cell for plain quads)
+} quad_instance_t;
+
+typedef struct {
+    // CPU-side instance stream
+    quad_instance_t *quads;
+    uint32_t count;
+    uint32_t capacity;
+    glyph_uv_t solid_uv;
+
+    // GL 3.3 resources (created lazily on the first flush with a current context)
+    bool gpu_ready;
+    bool gpu_failed;
+    GLuint program;
+    GLuint vao;
+    GLuint corner_vbo;
+    GLuint instance_vbo;
+    GLuint atlas_texture;
+    GLint u_view;
+    GLint u_atlas;
+    uint32_t gpu_capacity;
+
+    // Submitted since quad_batch_begin (for benchmarks and overlays)
+    uint32_t draw_calls;
+    uint32_t vertices;
+} quad_batch_t;
+
+// Allocate the instance stream (no GL calls)
+bool quad_batch_init(quad_batch_t *batch, uint32_t capacity);
+
+// Free the instance stream and GL resources (context must be current if a flush happened)
+void quad_batch_destroy(quad_batch_t *batch);
+
+// Start a new frame
+void quad_batch_begin(quad_batch_t *batch);
+
+// Append a solid quad (grows the stream when full)
+void quad_batch_push(quad_batch_t *batch, float x, float y, float width, float height,
+                     float r, float g, float b, float a);
+
+// Append a character quad (same cost as a solid quad: only the UV rectangle differs)
+void quad_batch_push_glyph(quad_batch_t *batch, float x, float y, float width, float height, char c,
+                           float r, float g, float b, float a);
+
+// Draw every queued quad in a view spanning [0, view_width] x [0, view_height]
+void quad_batch_flush(quad_batch_t *batch, float view_width, float view_height);
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Automatic visual quality scaling.
+// The editor reports how long each frame took to render. A governor keeps a
+// smoothed frame time and steps down one tier as soon as it exceeds the frame
+// budget, but steps back up only after a long stretch well under budget, so
+// the tier does not oscillate. An upgrade that immediately has to be undone
+// doubles the wait before the next attempt.
+
+#define QUALITY_TIER_COUNT 4
+#define QUALITY_DEFAULT_TIER (QUALITY_TIER_COUNT - 1)
+
+// Share of the display frame interval the editor may spend rendering
+#define QUALITY_BUDGET_FRACTION 0.5f
+
+// Smoothed frame time above budget * DOWN_RATIO steps down, below budget * UP_RATIO steps up
+#define QUALITY_DOWN_RATIO 1.0f
+#define QUALITY_UP_RATIO 0.5f
+
+// Frames the condition must hold, and frames ignored after a change while the average settles
+#define QUALITY_DOWN_FRAMES 15
+#define QUALITY_UP_FRAMES 180
+#define QUALITY_MAX_UP_FRAMES 2880
+#define QUALITY_SETTLE_FRAMES 10
+
+// What each tier draws
+typedef struct {
+    uint32_t trail_count;     // characters per falling column
+    bool glow;                // bloom pass
+    uint32_t spectrum_bars;
+    bool waterfall;           // spectrogram history behind the matrix
+} quality_settings_t;
+
+typedef struct {
+    uint32_t tier;            // 0 = cheapest
+    float budget_ms;
+    float average_ms;         // exponential moving average of frame time
+    uint32_t settle;          // frames left before decisions resume
+    uint32_t over_frames;
+    uint32_t under_frames;
+    uint32_t up_frames;       // current wait before stepping up
+    uint32_t frames_since_up; // for detecting upgrades that did not hold
+    bool pinned;              // tier held by the caller, frame times ignored
+} quality_governor_t;
+
+// Start at the top tier with a budget for the given display refresh (Hz)
+void quality_governor_init(quality_governor_t *governor, double refresh_hz);
+
+// Re-derive the budget after a refresh-rate change
+void quality_governor_set_refresh_rate(quality_governor_t *governor, double refresh_hz);
+
+// Hold a tier regardless of frame time (benchmarks, user override); tier < 0 resumes
+void quality_governor_pin(quality_governor_t *governor, int32_t tier);
+
+// Record one frame's render time; returns true when the tier changed
+bool quality_governor_record(quality_governor_t *governor, float frame_ms);
+
+// Settings of the current tier
+const quality_settings_t *quality_governor_settings(const quality_governor_t *governor);
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+// Per-lane xorshift32 generators.
+// Each lane is an independent stream owned by its caller, so editor instances
+// never share state, and advancing a whole array of lanes is one loop of
+// shifts and xors that vectorises.
+
+// Seed count lanes from one 64-bit seed (splitmix64; lanes are never zero)
+void rng_seed(uint32_t *state, uint32_t count, uint64_t seed);
+
+// Advance every lane once and write its new value to out
+void rng_next(uint32_t *state, uint32_t *out, uint32_t count);
+
+// Map a draw to [0, 1) using its top 24 bits
+static inline float rng_unit(uint32_t value) {
+    return (float)(value >> 8) * (1.0f / 16777216.0f);
+}
+
+// Map a draw to [0, range) using its top 16 bits (range up to 65536)
+static inline uint32_t rng_below(uint32_t value, uint32_t range) {
+    return ((value >> 16) * range) >> 16;
+}
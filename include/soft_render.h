@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quad_batch.h"
+
+// Software rasteriser for the quad batch.
+// Draws the same quad stream as quad_batch_flush into an RGBA8 pixel buffer
+// (top row first, opaque), for hosts and sessions without usable OpenGL and
+// for headless rendering. Blending is the GL SRC_ALPHA / ONE_MINUS_SRC_ALPHA
+// rule in 8-bit fixed point, one span at a time so the loops vectorise.
+//
+// Each row keeps a hash of the quads that touch it. Rows whose hash matches
+// the previous frame already hold the right pixels and are neither cleared
+// nor drawn; the rest are reported as dirty so callers only upload those.
+// Dirty rows start from a flat clear colour, or from a cached background
+// image that is built once per size.
+
+// Fill width x height opaque RGBA pixels, top row first, rows stride bytes apart
+typedef void (*soft_fill_t)(const void *user, uint8_t *pixels, uint32_t width, uint32_t height, uint32_t stride);
+
+typedef struct {
+    uint8_t *pixels;        // width * height * 4 bytes, RGBA
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;        // bytes per row
+
+    // Dirty rows of the last frame (row_dirty[y] != 0), with their bounds
+    uint8_t *row_dirty;
+    uint32_t dirty_first;
+    uint32_t dirty_last;    // exclusive; equal to dirty_first when nothing changed
+    uint32_t dirty_count;
+
+    // Per-row quad hashes of this frame and the previous one
+    uint64_t *row_hash;
+    uint64_t *row_hash_previous;
+    bool invalid;           // redraw every row next frame
+
+    // Per-span scratch: atlas column under each pixel, and each pixel's alpha
+    uint16_t *texel_x;
+    uint8_t *coverage;
+
+    // Background under every row (NULL: the clear colour), rebuilt on resize
+    uint8_t *background;
+    soft_fill_t background_fill;
+    const void *background_user;
+} soft_framebuffer_t;
+
+// Allocate a width x height buffer (every row starts dirty)
+bool soft_framebuffer_init(soft_framebuffer_t *framebuffer, uint32_t width, uint32_t height);
+
+// Reallocate for a new size (no-op when unchanged); the next frame redraws every row
+bool soft_framebuffer_resize(soft_framebuffer_t *framebuffer, uint32_t width, uint32_t height);
+
+void soft_framebuffer_destroy(soft_framebuffer_t *framebuffer);
+
+// Force the next frame to redraw every row
+void soft_framebuffer_invalidate(soft_framebuffer_t *framebuffer);
+
+// Draw frames over fill's image instead of the clear colour (NULL fill restores it);
+// the image is built now and after every resize
+bool soft_framebuffer_set_background(soft_framebuffer_t *framebuffer, soft_fill_t fill, const void *user);
+
+// Draw quads in order over the background or (clear_r, clear_g, clear_b), with the
+// view [0, view_width] x [0, view_height] (y up) mapped onto the whole buffer
+void soft_framebuffer_render(soft_framebuffer_t *framebuffer, const quad_instance_t *quads, uint32_t count,
+                             float view_width, float view_height,
+                             float clear_r, float clear_g, float clear_b);
+
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gl_ext.h"
+#include "analysis.h"
+
+// Scrolling spectrogram (waterfall) behind the matrix.
+// The history lives only on the GPU, as a texture ring of 8-bit log
+// magnitudes: one row per band set, SPECTROGRAM_ROWS rows. Each new analysis
+// snapshot becomes one row written with glTexSubImage2D (through alternating
+// pixel buffer objects), and scrolling is a texture-coordinate offset, so
+// memory and upload bandwidth do not depend on how long the history is.
+// Requires OpenGL 3.3.
+
+#define SPECTROGRAM_ROWS 256
+#define SPECTROGRAM_FLOOR_DB -72.0f  // maps to 0; 0 dBFS maps to 255
+
+typedef struct {
+    // Newest row, quantised on the CPU and uploaded by the next draw
+    uint8_t row[ANALYSIS_MAX_BANDS];
+    uint32_t width;               // bands per row
+    uint32_t last_sample_count;   // identifies the snapshot already in the history
+    bool has_snapshot;
+    bool row_pending;
+
+    // Ring position: the next row to write (the newest is just before it)
+    uint32_t head;
+
+    // GL resources (created lazily with a current context)
+    bool gpu_ready;
+    bool gpu_failed;
+    GLuint program;
+    GLuint vao;
+    GLuint texture;
+    GLuint pbo[2];
+    uint32_t pbo_index;
+    uint32_t texture_width;       // 0 until allocated for the current width
+    GLint u_offset;
+    GLint u_intensity;
+
+    float intensity;
+
+    // Submitted by the last spectrogram_draw
+    uint32_t draw_calls;
+    uint32_t vertices;
+} spectrogram_t;
+
+// Reset state (no GL calls)
+void spectrogram_init(spectrogram_t *spectrogram);
+
+// Release GL resources (context must be current if a draw happened)
+void spectrogram_destroy(spectrogram_t *spectrogram);
+
+// Quantise a snapshot into the pending row unless it is already in the history.
+// A new band count restarts the history. Returns true when a row was queued.
+bool spectrogram_push(spectrogram_t *spectrogram, const spectrum_analyzer_t *spectrum);
+
+// Upload the pending row and draw the history over the current viewport, newest
+// row at the top. Returns false when shaders are unavailable.
+bool spectrogram_draw(spectrogram_t *spectrogram);
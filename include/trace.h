@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Chrome trace event recorder for audio and GUI thread timing.
+// Each thread writes begin/end events into its own lock-free ring; a
+// background thread drains the rings into a Chrome trace JSON file that
+// opens in chrome://tracing or ui.perfetto.dev.
+//
+// Compiled out unless MATRIXFILTER_TRACE is defined (cmake -DENABLE_TRACE=ON).
+// The output path is taken from the MATRIXFILTER_TRACE_FILE environment
+// variable; nothing is recorded when it is unset.
+
+// Events per thread ring (power of two)
+#define TRACE_RING_SIZE 16384
+
+// Start the flush thread if tracing is requested (reference counted, not for the audio thread)
+void trace_init(void);
+
+// Release a trace_init() reference; the last one flushes and closes the file
+void trace_shutdown(void);
+
+// Name the calling thread in the trace (optional; also pre-allocates its ring)
+void trace_set_thread_name(const char *name);
+
+// Keep a spare ring for an audio thread (activate/setupProcessing, not the audio thread)
+void trace_reserve_audio_ring(void);
+
+// Mark the calling thread as real-time: it claims a spare ring without locking
+// or allocating, and its events are dropped when no spare is left
+void trace_audio_thread(void);
+
+// Record events (name must be a string literal or otherwise outlive the trace)
+void trace_begin(const char *name);
+void trace_end(const char *name);
+
+#ifdef MATRIXFILTER_TRACE
+
+// Scoped begin/end pair
+struct trace_scope_t {
+    const char *name;
+    explicit trace_scope_t(const char *scope_name) : name(scope_name) { trace_begin(name); }
+    ~trace_scope_t() { trace_end(name); }
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#define TRACE_INIT() trace_init()
+#define TRACE_SHUTDOWN() trace_shutdown()
+#define TRACE_THREAD_NAME(name) trace_set_thread_name(name)
+#define TRACE_RESERVE_AUDIO_RING() trace_reserve_audio_ring()
+#define TRACE_AUDIO_THREAD() trace_audio_thread()
+#define TRACE_BEGIN(name) trace_begin(name)
+#define TRACE_END(name) trace_end(name)
+#define TRACE_SCOPE(name) trace_scope_t TRACE_CONCAT(trace_scope_, __LINE__)(name)
+
+#else
+
+#define TRACE_INIT() ((void)0)
+#define TRACE_SHUTDOWN() ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_RESERVE_AUDIO_RING() ((void)0)
+#define TRACE_AUDIO_THREAD() ((void)0)
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END(name) ((void)0)
+#define TRACE_SCOPE(name) ((void)0)
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * LV2 Extension Shared Between Plugin and UI
+ * flark's MatrixFilter - LV2 Version
+ */
+
+#pragma once
+
+#include <lv2/lv2.h>
+#include "cpu_meter.h"
+#include "level_meter.h"
+#include "loudness.h"
+
+// Extension URIs (fetched by the UI through the data-access feature)
+#define LV2_MATRIXFILTER__cpuMeter "http://flark.dev/matrixfilter#cpuMeter"
+#define LV2_MATRIXFILTER__levelMeter "http://flark.dev/matrixfilter#levelMeter"
+#define LV2_MATRIXFILTER__loudnessMeter "http://flark.dev/matrixfilter#loudnessMeter"
+
+// Access to the plugin instance's per-block CPU load
+typedef struct {
+    cpu_meter_t* (*get_cpu_meter)(LV2_Handle instance);
+} MatrixFilterCpuMeterInterface;
+
+// Access to the plugin instance's output peak/RMS/correlation
+typedef struct {
+    level_meter_t* (*get_level_meter)(LV2_Handle instance);
+} MatrixFilterLevelMeterInterface;
+
+// Access to the plugin instance's EBU R128 loudness and true peak
+typedef struct {
+    const loudness_meter_t* (*get_loudness_meter)(LV2_Handle instance);
+} MatrixFilterLoudnessMeterInterface;
@@ -18,6 +18,8 @@
 
 // Include DSP header
 #include "../src/dsp.h"
+#include "matrixfilter-ext.h"
+#include "trace.h"
 
 // LV2 plugin URI
 #define LV2_MATRIXFILTER_URI "http://flark.dev/matrixfilter"
@@ -29,6 +31,7 @@ typedef struct {
     float gain;
     filter_type_t filter_type;
     bool enabled;
+    filter_channel_mode_t channel_mode;
     float sample_rate;
 } MatrixFilterPlugin;
 
@@ -60,8 +63,20 @@ typedef struct {
     float* output_buffer;
     uint32_t buffer_size;
     
-    // DSP
-    filter_t filter;
+    // Channel mode control port, read at the start of every run()
+    const float* channel_mode_port;
+    
+    // DSP (stereo bank with independent per-channel state)
+    filter_bank_t filter;
+    
+    // Per-block CPU load, read by the UI
+    cpu_meter_t cpu_meter;
+    
+    // Output peak/RMS/correlation, read by the UI
+    level_meter_t level_meter;
+    
+    // Output loudness (momentary/short-term/integrated LUFS, true peak), read by the UI
+    loudness_meter_t loudness_meter;
 } MatrixFilterInstance;
 
 // Plugin ports
@@ -75,6 +90,10 @@ enum {
     LV2_MATRIXFILTER_GAIN,
     LV2_MATRIXFILTER_FILTER_TYPE,
     LV2_MATRIXFILTER_ENABLED,
+    LV2_MATRIXFILTER_CHANNEL_MODE,
+    LV2_MATRIXFILTER_ANALYSIS_SIZE,
+    LV2_MATRIXFILTER_ANALYSIS_OVERLAP,
+    LV2_MATRIXFILTER_SPECTRUM_MODE,
     LV2_MATRIXFILTER_PORT_COUNT
 };
 
@@ -88,18 +107,22 @@ typedef struct {
 static void* instantiate(const LV2_Descriptor* descriptor, double sample_rate, const char* bundle_path, const LV2_Feature* const* features);
 static void cleanup(LV2_Handle instance);
 static void connect_port(LV2_Handle instance, uint32_t port, void* data_location);
+static void activate(LV2_Handle instance);
 static void run(LV2_Handle instance, uint32_t sample_count);
 static const LV2_Descriptor* get_descriptor(uint32_t index);
 static void free_instance(LV2_Handle instance);
+static const void* extension_data(const char* uri);
 
 // Plugin descriptor
 static const LV2_Descriptor plugin_descriptor = {
     LV2_MATRIXFILTER_URI,
     instantiate,
     connect_port,
+    activate,
     run,
+    NULL,  // deactivate
     free_instance,
-    NULL, // extension_data
+    extension_data,
 };
 
 // URI map callback
@@ -151,12 +174,19 @@ static void* instantiate(const LV2_Descriptor* descriptor, double sample_rate, c
     instance->plugin.gain = 0.0f;
     instance->plugin.filter_type = FILTER_TYPE_LOWPASS;
     instance->plugin.enabled = true;
+    instance->plugin.channel_mode = FILTER_CHANNEL_MODE_STEREO;
     instance->plugin.sample_rate = (float)sample_rate;
     
+    // Initialize meters and tracing
+    cpu_meter_init(&instance->cpu_meter);
+    level_meter_init(&instance->level_meter);
+    loudness_meter_init(&instance->loudness_meter, (float)sample_rate, 2);
+    TRACE_INIT();
+    
     // Initialize DSP
-    filter_init(&instance->filter, instance->plugin.filter_type, 
-                instance->plugin.cutoff_freq, instance->plugin.resonance, 
-                instance->plugin.gain, instance->plugin.sample_rate);
+    filter_bank_init(&instance->filter, instance->plugin.filter_type, 
+                     instance->plugin.cutoff_freq, instance->plugin.resonance, 
+                     instance->plugin.gain, instance->plugin.sample_rate, 2, 1);
     
     return instance;
 }
@@ -165,6 +195,7 @@ static void* instantiate(const LV2_Descriptor* descriptor, double sample_rate, c
 static void cleanup(LV2_Handle instance) {
     MatrixFilterInstance* plugin = (MatrixFilterInstance*)instance;
     if (plugin) {
+        TRACE_SHUTDOWN();
         if (plugin->input_buffer) free(plugin->input_buffer);
         if (plugin->output_buffer) free(plugin->output_buffer);
         free(plugin);
@@ -203,19 +234,47 @@ static void connect_port(LV2_Handle instance, uint32_t port, void* data_location
         case LV2_MATRIXFILTER_ENABLED:
             plugin->plugin.enabled = *(float*)data_location >= 0.5f;
             break;
+        case LV2_MATRIXFILTER_CHANNEL_MODE:
+            plugin->channel_mode_port = (const float*)data_location;
+            break;
+        case LV2_MATRIXFILTER_ANALYSIS_SIZE:
+        case LV2_MATRIXFILTER_ANALYSIS_OVERLAP:
+        case LV2_MATRIXFILTER_SPECTRUM_MODE:
+            // Editor settings: only the UI reads them, through port events
+            break;
     }
 }
 
+// Start of processing (not the audio thread)
+static void activate(LV2_Handle instance) {
+    MatrixFilterInstance* plugin = (MatrixFilterInstance*)instance;
+    if (!plugin) return;
+    
+    filter_bank_reset(&plugin->filter);
+    loudness_meter_reset(&plugin->loudness_meter);
+    
+    // Trace ring for the audio thread, so run() never allocates or locks for it
+    TRACE_RESERVE_AUDIO_RING();
+}
+
 // Plugin processing
 static void run(LV2_Handle instance, uint32_t sample_count) {
     MatrixFilterInstance* plugin = (MatrixFilterInstance*)instance;
     if (!plugin) return;
     
-    // Update filter parameters
-    filter_set_parameters(&plugin->filter, plugin->plugin.filter_type,
-                         plugin->plugin.cutoff_freq, plugin->plugin.resonance,
-                         plugin->plugin.gain);
-    filter_set_sample_rate(&plugin->filter, plugin->plugin.sample_rate);
+    TRACE_AUDIO_THREAD();
+    TRACE_SCOPE("run");
+    uint64_t block_start = cpu_meter_now_ns();
+    
+    // Update filter parameters (kernel is re-selected only when they change)
+    filter_bank_set_parameters(&plugin->filter, plugin->plugin.filter_type,
+                               plugin->plugin.cutoff_freq, plugin->plugin.resonance,
+                               plugin->plugin.gain);
+    filter_bank_set_sample_rate(&plugin->filter, plugin->plugin.sample_rate);
+    if (plugin->channel_mode_port) {
+        plugin->plugin.channel_mode = (filter_channel_mode_t)(int)(*plugin->channel_mode_port + 0.5f);
+    }
+    filter_bank_set_channel_mode(&plugin->filter, plugin->plugin.channel_mode);
     
     // Get audio ports (simplified for stereo)
     float* input_l = (float*)plugin->input_buffer;  // Would be connected via connect_port
@@ -224,18 +283,67 @@ static void run(LV2_Handle instance, uint32_t sample_count) {
     float* output_r = (float*)plugin->output_buffer;
     
     // Process audio if inputs/outputs are connected and filter is enabled
-    if (plugin->plugin.enabled && plugin->filter.initialized) {
+    if (plugin->plugin.enabled && plugin->filter.filter.initialized) {
         // In a real implementation, audio ports would be properly connected
         // For now, this is a simplified version
-        if (input_l && output_l) {
-            // Process left channel
-            filter_process_block(&plugin->filter, input_l, output_l, sample_count);
+        if (input_l && output_l && input_r && output_r) {
+            // Process both channels in one pass through the stereo kernel
+            const float* inputs[2] = { input_l, input_r };
+            float* outputs[2] = { output_l, output_r };
+            filter_bank_process(&plugin->filter, inputs, outputs, sample_count);
         }
-        if (input_r && output_r) {
-            // Process right channel
-            filter_process_block(&plugin->filter, input_r, output_r, sample_count);
+    }
+    
+    // Output levels for the UI, in one pass over the block
+    if (output_l && output_r) {
+        const float* outputs[2] = { output_l, output_r };
+        level_meter_record(&plugin->level_meter, outputs, 2, sample_count, plugin->plugin.sample_rate);
+        
+        // EBU R128 loudness and true peak
+        if (plugin->loudness_meter.sample_rate != plugin->plugin.sample_rate) {
+            loudness_meter_init(&plugin->loudness_meter, plugin->plugin.sample_rate, 2);
         }
+        loudness_meter_process(&plugin->loudness_meter, outputs, sample_count);
+    }
+    
+    cpu_meter_record(&plugin->cpu_meter, cpu_meter_now_ns() - block_start,
+                     sample_count, plugin->plugin.sample_rate);
+}
+
+// CPU meter accessor for the UI
+static cpu_meter_t* get_cpu_meter(LV2_Handle instance) {
+    MatrixFilterInstance* plugin = (MatrixFilterInstance*)instance;
+    return plugin ? &plugin->cpu_meter : NULL;
+}
+
+// Level meter accessor for the UI
+static level_meter_t* get_level_meter(LV2_Handle instance) {
+    MatrixFilterInstance* plugin = (MatrixFilterInstance*)instance;
+    return plugin ? &plugin->level_meter : NULL;
+}
+
+// Loudness meter accessor for the UI
+static const loudness_meter_t* get_loudness_meter(LV2_Handle instance) {
+    MatrixFilterInstance* plugin = (MatrixFilterInstance*)instance;
+    return plugin ? &plugin->loudness_meter : NULL;
+}
+
+// Extension data
+static const void* extension_data(const char* uri) {
+    static const MatrixFilterCpuMeterInterface cpu_meter_iface = { get_cpu_meter };
+    static const MatrixFilterLevelMeterInterface level_meter_iface = { get_level_meter };
+    static const MatrixFilterLoudnessMeterInterface loudness_meter_iface = { get_loudness_meter };
+    
+    if (!strcmp(uri, LV2_MATRIXFILTER__cpuMeter)) {
+        return &cpu_meter_iface;
+    }
+    if (!strcmp(uri, LV2_MATRIXFILTER__levelMeter)) {
+        return &level_meter_iface;
+    }
+    if (!strcmp(uri, LV2_MATRIXFILTER__loudnessMeter)) {
+        return &loudness_meter_iface;
     }
+    return NULL;
 }
 
 // Plugin descriptor accessor
@@ -6,6 +6,8 @@
 #include <lv2/lv2plug.in/ns/extensions/ui/ui.h>
 #include <lv2/lv2plug.in/ns/extensions/options/options.h>
 #include <lv2/lv2plug.in/ns/ext/uri-map/uri-map.h>
+#include <lv2/lv2plug.in/ns/ext/instance-access/instance-access.h>
+#include <lv2/lv2plug.in/ns/ext/data-access/data-access.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,6 +24,8 @@
 
 // Include GUI header
 #include "../src/gui.h"
+#include "matrixfilter-ext.h"
+#include "gl_window.h"
 
 // LV2 UI URI
 #define LV2_MATRIXFILTER_UI_URI "http://flark.dev/matrixfilter_ui"
@@ -31,8 +35,9 @@ typedef struct {
     LV2UI_Write_Function write_function;
     LV2UI_Controller controller;
     
-    // OpenGL context
-    void* gl_context;
+    // Editor window inside the host's parent; its GL context shares the
+    // process-wide cache group with every other open editor
+    gl_window_t window;
     
     // UI features
     const LV2_URID_Map* urid_map;
@@ -41,12 +46,16 @@ typedef struct {
     // Matrix effect instance
     MatrixEffect matrix_effect;
     
+    // Overlay drawn over the matrix; its scheduler paces every frame
+    gui_context_t gui;
+    
+    // Spectrum analysis settings from the analysis_size / analysis_overlap ports
+    uint32_t analysis_size;
+    uint32_t analysis_overlap;
+    
     // Window dimensions
     int width;
     int height;
-    
-    // Animation timer
-    double last_time;
     bool running;
 } MatrixFilterUI;
 
@@ -57,6 +66,9 @@ static int select_func(LV2UI_Feature_Handle handle, const char* feature);
 static int subscribe(LV2UI_Handle handle, uint32_t port_index, uint32_t format, const LV2_Feature* const* features);
 static int unsubscribe(LV2UI_Handle handle, uint32_t port_index, uint32_t format, const LV2_Feature* const* features);
 static void free_instance(LV2UI_Handle instance);
+static int ui_idle(LV2UI_Handle handle);
+static int ui_show(LV2UI_Handle handle);
+static int ui_hide(LV2UI_Handle handle);
 
 // UI descriptor
 static const LV2UI_Descriptor ui_descriptor = {
@@ -78,9 +90,18 @@ static const void* extension_data(const char* uri) {
         unsubscribe
     };
     
+    static const LV2UI_Idle_Interface idle = { ui_idle };
+    static const LV2UI_Show_Interface show = { ui_show, ui_hide };
+    
     if (!strcmp(uri, LV2_UI__portSubscribe)) {
         return &extension;
     }
+    if (!strcmp(uri, LV2_UI__idleInterface)) {
+        return &idle;
+    }
+    if (!strcmp(uri, LV2_UI__showInterface)) {
+        return &show;
+    }
     return NULL;
 }
 
@@ -98,28 +119,76 @@ static LV2UI_Handle instantiate(const LV2UI_Descriptor* descriptor, const char*
     ui->width = 800;
     ui->height = 600;
     ui->running = true;
-    ui->last_time = 0.0;
     
     // Extract features
+    void* parent = NULL;
+    LV2_Handle plugin_instance = NULL;
+    const LV2_Extension_Data_Feature* data_access = NULL;
+    
     for (int i = 0; features[i]; i++) {
         if (!strcmp(features[i]->URI, LV2_URID__map)) {
             ui->urid_map = (const LV2_URID_Map*)features[i]->data;
         } else if (!strcmp(features[i]->URI, LV2_UI__parent)) {
-            ui->gl_context = features[i]->data;
+            parent = features[i]->data;
+        } else if (!strcmp(features[i]->URI, LV2_INSTANCE_ACCESS_URI)) {
+            plugin_instance = (LV2_Handle)features[i]->data;
+        } else if (!strcmp(features[i]->URI, LV2_DATA_ACCESS_URI)) {
+            data_access = (const LV2_Extension_Data_Feature*)features[i]->data;
         }
     }
     
     // Initialize matrix effect
     MatrixEffect_Init(&ui->matrix_effect, ui->width, ui->height);
     
-    // Create widget (platform-specific)
-    ui->gl_context = create_opengl_widget(ui->width, ui->height);
-    *widget = ui->gl_context;
+    // Create widget: a child of the host's window with a shared GL context
+    if (!gl_window_create(&ui->window, parent, (uint32_t)ui->width, (uint32_t)ui->height)) {
+        free(ui);
+        return NULL;
+    }
+    *widget = gl_window_handle(&ui->window);
+    
+    if (!gui_create(&ui->gui, NULL, (uint32_t)ui->width, (uint32_t)ui->height)) {
+        gl_window_destroy(&ui->window);
+        free(ui);
+        return NULL;
+    }
     
-    if (!ui->gl_context) {
+    // No GL context: frames are rasterised in software and shown by the window instead
+    if (!gl_window_has_gl(&ui->window) && !gui_set_backend(&ui->gui, GUI_BACKEND_SOFTWARE)) {
+        gui_destroy(&ui->gui);
+        gl_window_destroy(&ui->window);
         free(ui);
         return NULL;
     }
+    ui->analysis_size = ANALYSIS_DEFAULT_FFT_SIZE;
+    ui->analysis_overlap = ANALYSIS_DEFAULT_OVERLAP;
+    
+    // Hook up the plugin's CPU meter when running in the same process (drawn by the overlay)
+    if (plugin_instance && data_access) {
+        const MatrixFilterCpuMeterInterface* iface =
+            (const MatrixFilterCpuMeterInterface*)data_access->data_access(LV2_MATRIXFILTER__cpuMeter);
+        if (iface) {
+            gui_set_cpu_meter(&ui->gui, iface->get_cpu_meter(plugin_instance));
+        }
+    }
+    
+    // Likewise its output level meter
+    if (plugin_instance && data_access) {
+        const MatrixFilterLevelMeterInterface* iface =
+            (const MatrixFilterLevelMeterInterface*)data_access->data_access(LV2_MATRIXFILTER__levelMeter);
+        if (iface) {
+            gui_set_level_meter(&ui->gui, iface->get_level_meter(plugin_instance));
+        }
+    }
+    
+    // And its loudness meter
+    if (plugin_instance && data_access) {
+        const MatrixFilterLoudnessMeterInterface* iface =
+            (const MatrixFilterLoudnessMeterInterface*)data_access->data_access(LV2_MATRIXFILTER__loudnessMeter);
+        if (iface) {
+            gui_set_loudness_meter(&ui->gui, iface->get_loudness_meter(plugin_instance));
+        }
+    }
     
     return ui;
 }
@@ -128,9 +197,10 @@ static LV2UI_Handle instantiate(const LV2UI_Descriptor* descriptor, const char*
 static void cleanup(LV2UI_Handle instance) {
     MatrixFilterUI* ui = (MatrixFilterUI*)instance;
     if (ui) {
-        if (ui->gl_context) {
-            destroy_opengl_widget(ui->gl_context);
-        }
+        // GL objects go with the context current, before it leaves the cache group
+        gl_window_make_current(&ui->window);
+        gui_destroy(&ui->gui);
+        gl_window_destroy(&ui->window);
         MatrixEffect_Destroy(&ui->matrix_effect);
         free(ui);
     }
@@ -173,6 +243,23 @@ static void port_event(LV2UI_Handle instance, uint32_t port, uint32_t size, uint
                 MatrixEffect_UpdateParameter(&ui->matrix_effect, PARAM_ENABLED, enabled > 0.5f);
             }
             break;
+        case 10: // Analysis FFT size
+            if (size == sizeof(float) && format == 0) {
+                ui->analysis_size = (uint32_t)*(const float*)buffer;
+                gui_set_analysis(&ui->gui, ui->analysis_size, ui->analysis_overlap);
+            }
+            break;
+        case 11: // Analysis overlap
+            if (size == sizeof(float) && format == 0) {
+                ui->analysis_overlap = (uint32_t)*(const float*)buffer;
+                gui_set_analysis(&ui->gui, ui->analysis_size, ui->analysis_overlap);
+            }
+            break;
+        case 12: // Spectrum mode
+            if (size == sizeof(float) && format == 0) {
+                gui_set_spectrum_mode(&ui->gui, (uint32_t)*(const float*)buffer);
+            }
+            break;
     }
 }
 
@@ -183,33 +270,67 @@ static int select_func(LV2UI_Feature_Handle handle, const char* feature) {
     
     // Handle UI-specific features
     if (!strcmp(feature, LV2_UI__idleInterface)) {
-        // Handle idle interface for animation
-        if (ui->running && ui->gl_context) {
-            // Update animation
-            double current_time = get_time();
-            double delta_time = current_time - ui->last_time;
-            
-            // Update matrix effect
-            MatrixEffect_Update(&ui->matrix_effect, delta_time);
-            
-            // Render
-            render_matrix_effect(ui->gl_context, &ui->matrix_effect);
-            
-            ui->last_time = current_time;
-        }
+        ui_idle(handle);
         return 1;
     }
     
     return 0;
 }
 
+// Idle callback: hosts call this far more often than frames are needed, so
+// only render when the overlay's scheduler says a frame is due (display rate,
+// the idle rate once settled, nothing while hidden)
+static int ui_idle(LV2UI_Handle handle) {
+    MatrixFilterUI* ui = (MatrixFilterUI*)handle;
+    if (!ui || !ui->running) return 0;
+    
+    if (!gui_update(&ui->gui, NULL, 0, 0.0)) {
+        return 0;
+    }
+    
+    // Update matrix effect by the real elapsed time
+    MatrixEffect_Update(&ui->matrix_effect, ui->gui.frame_step);
+    
+    // Software: the whole frame, overlay included, then only its changed rows are shown
+    soft_framebuffer_t* frame = gui_framebuffer(&ui->gui);
+    if (frame) {
+        gui_render(&ui->gui);
+        gl_window_present(&ui->window, frame);
+        gui_frame_presented(&ui->gui);
+        return 0;
+    }
+    if (!gl_window_make_current(&ui->window)) {
+        return 0;
+    }
+    
+    // Render the matrix, then the overlay on top
+    render_matrix_effect(ui->window.context, &ui->matrix_effect);
+    gui_render_overlay(&ui->gui);
+    gl_window_swap(&ui->window);
+    gui_frame_presented(&ui->gui);
+    return 0;
+}
+
+// Window shown or hidden by the host: hidden windows get no frames
+static int ui_show(LV2UI_Handle handle) {
+    MatrixFilterUI* ui = (MatrixFilterUI*)handle;
+    if (ui) gui_set_visible(&ui->gui, true);
+    return 0;
+}
+
+static int ui_hide(LV2UI_Handle handle) {
+    MatrixFilterUI* ui = (MatrixFilterUI*)handle;
+    if (ui) gui_set_visible(&ui->gui, false);
+    return 0;
+}
+
 // Subscribe to port updates
 static int subscribe(LV2UI_Handle handle, uint32_t port_index, uint32_t format, const LV2_Feature* const* features) {
     MatrixFilterUI* ui = (MatrixFilterUI*)handle;
     if (!ui) return -1;
     
     // Subscribe to parameter ports for real-time updates
-    if (port_index >= 4 && port_index <= 8 && format == 0) {
+    if (((port_index >= 4 && port_index <= 8) || (port_index >= 10 && port_index <= 12)) && format == 0) {
         // Parameters we care about
         return 0; // Success
     }
@@ -222,34 +343,6 @@ static int unsubscribe(LV2UI_Handle handle, uint32_t port_index, uint32_t format
     return 0; // Always succeed
 }
 
-// Helper functions for platform-specific OpenGL widget creation
-static void* create_opengl_widget(int width, int height) {
-    // This would be implemented differently for each platform
-    // Linux: X11 + GLX
-    // Windows: Win32 + WGL
-    // macOS: Cocoa + NSOpenGL
-    
-    // For demonstration, return a dummy widget pointer
-    // In a real implementation, this would create the actual GL context
-    void* widget = malloc(sizeof(unsigned int)); // Dummy widget
-    return widget;
-}
-
-static void destroy_opengl_widget(void* widget) {
-    if (widget) {
-        free(widget);
-    }
-}
-
-static double get_time() {
-    // Return current time in seconds
-    static double start_time = 0.0;
-    if (start_time == 0.0) {
-        start_time = get_current_time_seconds();
-    }
-    return get_current_time_seconds() - start_time;
-}
-
 // UI entry points
 LV2_SYMBOL_EXPORT
 const LV2UI_Descriptor* lv2ui_descriptor(uint32_t index) {
@@ -0,0 +1,455 @@
+#include "analysis.h"
+#include "trace.h"
+#include "cpu_meter.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#define ANALYSIS_FRESH 4u
+
+static uint32_t analysis_pack_config(uint32_t fft_size, uint32_t overlap_percent) {
+    return fft_size | (overlap_percent << 16);
+}
+
+// Spectrum analyzer initialization
+void spectrum_init(spectrum_analyzer_t *spectrum) {
+    memset(spectrum, 0, sizeof(spectrum_analyzer_t));
+    spectrum->sample_count = 0;
+}
+
+bool spectrum_engine_init(spectrum_engine_t *engine, uint32_t fft_size, uint32_t overlap_percent) {
+    memset(engine, 0, sizeof(spectrum_engine_t));
+    
+    if (!fft_plan_init(&engine->plan, fft_size)) {
+        return false;
+    }
+    
+    uint32_t bins = fft_size / 2 + 1;
+    engine->fft_size = fft_size;
+    engine->hop = fft_size * (100 - overlap_percent) / 100;
+    
+    // One block for every buffer: window, history, windowed, staging, re, im, power, bands
+    float *block = (float *)calloc(3 * fft_size + engine->hop + 3 * bins + ANALYSIS_MAX_BANDS, sizeof(float));
+    if (!block) {
+        fft_plan_destroy(&engine->plan);
+        return false;
+    }
+    
+    engine->window = block;
+    engine->history = engine->window + fft_size;
+    engine->windowed = engine->history + fft_size;
+    engine->staging = engine->windowed + fft_size;
+    engine->re = engine->staging + engine->hop;
+    engine->im = engine->re + bins;
+    engine->power_sum = engine->im + bins;
+    engine->band_power = engine->power_sum + bins;
+    
+    // Periodic Hann: overlapped segments sum to a constant at 50% and 75% overlap
+    for (uint32_t i = 0; i < fft_size; i++) {
+        engine->window[i] = 0.5f - 0.5f * cosf(2.0f * M_PI * i / fft_size);
+    }
+    
+    return true;
+}
+
+void spectrum_engine_destroy(spectrum_engine_t *engine) {
+    free(engine->window);
+    fft_plan_destroy(&engine->plan);
+    memset(engine, 0, sizeof(spectrum_engine_t));
+}
+
+uint32_t spectrum_engine_feed(spectrum_engine_t *engine, audio_ring_t *ring, uint32_t max_segments,
+                              const cqt_kernel_t *cqt) {
+    const uint32_t size = engine->fft_size;
+    const uint32_t hop = engine->hop;
+    const uint32_t bins = size / 2 + 1;
+    
+    // Bound the work per pass: audio this pass cannot transform is skipped, oldest first
+    uint32_t budget = max_segments * hop - engine->pending;
+    uint32_t available = audio_ring_available(ring);
+    if (available > budget) {
+        audio_ring_skip(ring, available - budget);
+    }
+    
+    uint32_t segments = 0;
+    while (segments < max_segments) {
+        engine->pending += audio_ring_read(ring, engine->staging + engine->pending, hop - engine->pending);
+        if (engine->pending < hop) break;
+        engine->pending = 0;
+        
+        // Slide the segment by one hop
+        memmove(engine->history, engine->history + hop, (size - hop) * sizeof(float));
+        memcpy(engine->history + size - hop, engine->staging, hop * sizeof(float));
+        
+        for (uint32_t i = 0; i < size; i++) {
+            engine->windowed[i] = engine->history[i] * engine->window[i];
+        }
+        
+        fft_real_forward(&engine->plan, engine->windowed, engine->re, engine->im);
+        
+        for (uint32_t k = 0; k < bins; k++) {
+            engine->power_sum[k] += engine->re[k] * engine->re[k] + engine->im[k] * engine->im[k];
+        }
+        if (cqt) {
+            cqt_kernel_accumulate(cqt, engine->re, engine->im, engine->band_power);
+        }
+        segments++;
+    }
+    
+    engine->segments += segments;
+    return segments;
+}
+
+void spectrum_engine_publish(spectrum_engine_t *engine, const band_map_t *band_map,
+                             const cqt_kernel_t *cqt, spectrum_analyzer_t *spectrum) {
+    if (engine->segments == 0) return;
+    
+    const uint32_t bins = engine->fft_size / 2;
+    const uint32_t display_bins = MAX_FREQUENCY_BINS / 2;
+    const float average = 1.0f / engine->segments;
+    const float normalize = 1.0f / engine->fft_size;
+    
+    // Each display bin shows the strongest FFT bin it covers, as magnitude
+    for (uint32_t i = 0; i < display_bins; i++) {
+        uint32_t first = i * bins / display_bins;
+        uint32_t last = (i + 1) * bins / display_bins;
+        float peak = 0.0f;
+        for (uint32_t k = first; k < last; k++) {
+            peak = fmaxf(peak, engine->power_sum[k]);
+        }
+        spectrum->spectrum[i] = sqrtf(peak * average) * normalize;
+    }
+    
+    // Apply some smoothing
+    for (uint32_t i = 1; i < display_bins; i++) {
+        spectrum->spectrum[i] = (spectrum->spectrum[i] * 0.7f) + (spectrum->spectrum[i-1] * 0.3f);
+    }
+    
+    if (cqt) {
+        // Constant-Q energies were accumulated per segment (the kernel carries the 1/N)
+        for (uint32_t b = 0; b < cqt->band_count; b++) {
+            spectrum->bands[b] = sqrtf(engine->band_power[b] * average);
+        }
+        spectrum->band_count = cqt->band_count;
+        spectrum->band_min_hz = cqt->min_hz;
+    } else {
+        // Band energies: one sparse product over the accumulated power
+        band_map_apply(band_map, engine->power_sum, spectrum->bands);
+        for (uint32_t b = 0; b < band_map->band_count; b++) {
+            spectrum->bands[b] = sqrtf(spectrum->bands[b] * average) * normalize;
+        }
+        spectrum->band_count = band_map->band_count;
+        spectrum->band_min_hz = ANALYSIS_BAND_MIN_HZ;
+    }
+    
+    memset(engine->power_sum, 0, (bins + 1) * sizeof(float));
+    memset(engine->band_power, 0, ANALYSIS_MAX_BANDS * sizeof(float));
+    engine->segments = 0;
+}
+
+// Update peak values for decay effect
+void spectrum_update_peaks(spectrum_analyzer_t *spectrum) {
+    for (int i = 0; i < MAX_FREQUENCY_BINS / 2; i++) {
+        if (spectrum->spectrum[i] > spectrum->peak_values[i]) {
+            spectrum->peak_values[i] = spectrum->spectrum[i];
+        } else {
+            spectrum->peak_values[i] *= 0.95f; // Decay
+        }
+    }
+}
+
+
+static void analysis_sleep_ms(uint32_t ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
+// Analysis only feeds the display: let audio and UI threads win
+static void analysis_lower_priority(void) {
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#elif defined(SCHED_IDLE)
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+}
+
+// Bring queued host-rate audio down to the analysis rate
+static void analysis_worker_decimate(analysis_worker_t *worker) {
+    decimator_t *decimator = &worker->decimator;
+    
+    // Audio the estimator would skip anyway is dropped before filtering
+    uint32_t budget = (ANALYSIS_MAX_SEGMENTS_PER_PASS * worker->engine.hop) * decimator->factor;
+    uint32_t available = audio_ring_available(&worker->ring);
+    if (available > budget) {
+        audio_ring_skip(&worker->ring, available - budget);
+    }
+    
+    // Filter no more than the decimated ring can take; the rest waits for the next pass
+    uint32_t room = worker->decimated.capacity - audio_ring_available(&worker->decimated);
+    uint32_t count;
+    while (room > DECIMATOR_BLOCK / decimator->factor &&
+           (count = audio_ring_read(&worker->ring, worker->decimate_input, DECIMATOR_BLOCK)) > 0) {
+        uint32_t produced = decimator_process(decimator, worker->decimate_input, count, worker->decimate_output);
+        audio_ring_write(&worker->decimated, worker->decimate_output, produced);
+        room -= produced;
+    }
+}
+
+// Apply a pending reconfiguration, then run the Welch estimator on queued audio
+static bool analysis_worker_drain(analysis_worker_t *worker) {
+    // Constant-Q kernels only reach bass notes in long segments, so that mode
+    // holds the FFT size at its floor whatever size was requested
+    uint32_t mode = worker->mode.load(std::memory_order_relaxed);
+    uint32_t config = worker->config.load(std::memory_order_acquire);
+    if (mode == ANALYSIS_MODE_CONSTANT_Q && (config & 0xffff) < ANALYSIS_CQT_MIN_FFT_SIZE) {
+        config = analysis_pack_config(ANALYSIS_CQT_MIN_FFT_SIZE, config >> 16);
+    }
+    if (config != worker->applied_config) {
+        spectrum_engine_t engine;
+        if (spectrum_engine_init(&engine, config & 0xffff, config >> 16)) {
+            spectrum_engine_destroy(&worker->engine);
+            worker->engine = engine;
+        }
+        worker->applied_config = config;
+    }
+    
+    // The decimation factor follows the host rate; audio already filtered at the old rate is dropped
+    uint32_t sample_rate = worker->sample_rate.load(std::memory_order_relaxed);
+    uint32_t factor = decimator_factor_for_rate(sample_rate, ANALYSIS_MIN_RATE);
+    if (factor != worker->decimator.factor) {
+        decimator_t decimator;
+        if (decimator_init(&decimator, factor)) {
+            decimator_destroy(&worker->decimator);
+            worker->decimator = decimator;
+            audio_ring_skip(&worker->decimated, audio_ring_available(&worker->decimated));
+        }
+    }
+    double analysis_rate = (double)sample_rate / worker->decimator.factor;
+    
+    // The band map depends on FFT size, analysis rate and band count
+    uint32_t band_count = worker->band_count.load(std::memory_order_relaxed);
+    if (worker->band_map.fft_size != worker->engine.fft_size ||
+        worker->band_map.sample_rate != analysis_rate ||
+        worker->band_map.band_count != band_count) {
+        band_map_t band_map;
+        if (band_map_build(&band_map, band_count, worker->engine.fft_size, analysis_rate,
+                           ANALYSIS_BAND_MIN_HZ, ANALYSIS_BAND_MAX_HZ)) {
+            band_map_destroy(&worker->band_map);
+            worker->band_map = band_map;
+        }
+    }
+    
+    // The constant-Q kernel likewise, built only while that mode is selected
+    const cqt_kernel_t *cqt = NULL;
+    if (mode == ANALYSIS_MODE_CONSTANT_Q) {
+        if (worker->cqt.fft_size != worker->engine.fft_size ||
+            worker->cqt.sample_rate != analysis_rate ||
+            worker->cqt.band_count != band_count) {
+            cqt_kernel_t kernel;
+            if (cqt_kernel_build(&kernel, band_count, ANALYSIS_CQT_BINS_PER_OCTAVE,
+                                 worker->engine.fft_size, analysis_rate)) {
+                cqt_kernel_destroy(&worker->cqt);
+                worker->cqt = kernel;
+            }
+        }
+        if (worker->cqt.band_count > 0) {
+            cqt = &worker->cqt;
+        }
+    }
+    
+    // Pass cost covers the bounded part only; map and kernel rebuilds are one-off
+    uint64_t start = cpu_meter_now_ns();
+    uint32_t segments;
+    {
+        TRACE_SCOPE("spectrum_engine_feed");
+        audio_ring_t *source = &worker->ring;
+        if (worker->decimator.factor > 1) {
+            analysis_worker_decimate(worker);
+            source = &worker->decimated;
+        }
+        segments = spectrum_engine_feed(&worker->engine, source, ANALYSIS_MAX_SEGMENTS_PER_PASS, cqt);
+    }
+    if (segments == 0) return false;
+    
+    spectrum_engine_publish(&worker->engine, &worker->band_map, cqt, &worker->working);
+    spectrum_update_peaks(&worker->working);
+    worker->working.sample_count += segments * worker->engine.hop;
+    
+    // Single writer, so plain load and store
+    uint64_t elapsed = cpu_meter_now_ns() - start;
+    worker->pass_ns_total.store(worker->pass_ns_total.load(std::memory_order_relaxed) + elapsed,
+                                std::memory_order_relaxed);
+    if (elapsed > worker->pass_ns_max.load(std::memory_order_relaxed)) {
+        worker->pass_ns_max.store(elapsed, std::memory_order_relaxed);
+    }
+    worker->pass_count.store(worker->pass_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    return true;
+}
+
+// Hand the finished frame to the reader and take back the spare slot
+static void analysis_worker_publish(analysis_worker_t *worker) {
+    worker->slots[worker->write_index] = worker->working;
+    uint32_t previous = worker->shared.exchange(worker->write_index | ANALYSIS_FRESH,
+                                                std::memory_order_acq_rel);
+    worker->write_index = previous & ~ANALYSIS_FRESH;
+}
+
+static void *analysis_worker_thread(void *arg) {
+    analysis_worker_t *worker = (analysis_worker_t *)arg;
+
+    analysis_lower_priority();
+    TRACE_THREAD_NAME("analysis");
+
+    while (worker->running.load(std::memory_order_acquire)) {
+        if (analysis_worker_drain(worker)) {
+            analysis_worker_publish(worker);
+        }
+        analysis_sleep_ms(ANALYSIS_POLL_MS);
+    }
+
+    return NULL;
+}
+
+bool analysis_worker_start(analysis_worker_t *worker) {
+    spectrum_init(&worker->working);
+    for (int i = 0; i < 3; i++) {
+        spectrum_init(&worker->slots[i]);
+    }
+
+    // Slot 0 is being written, 1 is shared, 2 is held by the reader
+    worker->write_index = 0;
+    worker->shared.store(1, std::memory_order_relaxed);
+    worker->read_index = 2;
+    worker->started = false;
+
+    worker->applied_config = analysis_pack_config(ANALYSIS_DEFAULT_FFT_SIZE, ANALYSIS_DEFAULT_OVERLAP);
+    worker->config.store(worker->applied_config, std::memory_order_relaxed);
+    worker->sample_rate.store(ANALYSIS_DEFAULT_SAMPLE_RATE, std::memory_order_relaxed);
+    worker->band_count.store(ANALYSIS_DEFAULT_BANDS, std::memory_order_relaxed);
+    worker->mode.store(ANALYSIS_MODE_LOG_FFT, std::memory_order_relaxed);
+    worker->pass_ns_total.store(0, std::memory_order_relaxed);
+    worker->pass_ns_max.store(0, std::memory_order_relaxed);
+    worker->pass_count.store(0, std::memory_order_relaxed);
+    memset(&worker->cqt, 0, sizeof(cqt_kernel_t));
+    if (!spectrum_engine_init(&worker->engine, ANALYSIS_DEFAULT_FFT_SIZE, ANALYSIS_DEFAULT_OVERLAP)) {
+        return false;
+    }
+    
+    if (!band_map_build(&worker->band_map, ANALYSIS_DEFAULT_BANDS, ANALYSIS_DEFAULT_FFT_SIZE,
+                        ANALYSIS_DEFAULT_SAMPLE_RATE, ANALYSIS_BAND_MIN_HZ, ANALYSIS_BAND_MAX_HZ)) {
+        spectrum_engine_destroy(&worker->engine);
+        return false;
+    }
+    
+    if (!decimator_init(&worker->decimator, 1)) {
+        band_map_destroy(&worker->band_map);
+        spectrum_engine_destroy(&worker->engine);
+        return false;
+    }
+    
+    if (!audio_ring_init(&worker->ring, ANALYSIS_RING_SIZE)) {
+        decimator_destroy(&worker->decimator);
+        band_map_destroy(&worker->band_map);
+        spectrum_engine_destroy(&worker->engine);
+        return false;
+    }
+    
+    if (!audio_ring_init(&worker->decimated, ANALYSIS_DECIMATED_RING_SIZE)) {
+        audio_ring_destroy(&worker->ring);
+        decimator_destroy(&worker->decimator);
+        band_map_destroy(&worker->band_map);
+        spectrum_engine_destroy(&worker->engine);
+        return false;
+    }
+
+    worker->running.store(true, std::memory_order_release);
+    if (pthread_create(&worker->thread, NULL, analysis_worker_thread, worker) != 0) {
+        worker->running.store(false, std::memory_order_relaxed);
+        audio_ring_destroy(&worker->decimated);
+        audio_ring_destroy(&worker->ring);
+        decimator_destroy(&worker->decimator);
+        band_map_destroy(&worker->band_map);
+        spectrum_engine_destroy(&worker->engine);
+        return false;
+    }
+
+    worker->started = true;
+    return true;
+}
+
+void analysis_worker_stop(analysis_worker_t *worker) {
+    if (!worker->started) return;
+
+    worker->running.store(false, std::memory_order_release);
+    pthread_join(worker->thread, NULL);
+    audio_ring_destroy(&worker->decimated);
+    audio_ring_destroy(&worker->ring);
+    decimator_destroy(&worker->decimator);
+    band_map_destroy(&worker->band_map);
+    cqt_kernel_destroy(&worker->cqt);
+    spectrum_engine_destroy(&worker->engine);
+    worker->started = false;
+}
+
+void analysis_worker_configure(analysis_worker_t *worker, uint32_t fft_size, uint32_t overlap_percent) {
+    uint32_t size = ANALYSIS_MIN_FFT_SIZE;
+    while (size < fft_size && size < ANALYSIS_MAX_FFT_SIZE) {
+        size <<= 1;
+    }
+    
+    if (overlap_percent < ANALYSIS_MIN_OVERLAP) overlap_percent = ANALYSIS_MIN_OVERLAP;
+    if (overlap_percent > ANALYSIS_MAX_OVERLAP) overlap_percent = ANALYSIS_MAX_OVERLAP;
+    
+    worker->config.store(analysis_pack_config(size, overlap_percent), std::memory_order_release);
+}
+
+void analysis_worker_set_sample_rate(analysis_worker_t *worker, double sample_rate) {
+    if (sample_rate >= 1.0) {
+        worker->sample_rate.store((uint32_t)(sample_rate + 0.5), std::memory_order_relaxed);
+    }
+}
+
+void analysis_worker_set_band_count(analysis_worker_t *worker, uint32_t band_count) {
+    if (band_count < 1) band_count = 1;
+    if (band_count > ANALYSIS_MAX_BANDS) band_count = ANALYSIS_MAX_BANDS;
+    worker->band_count.store(band_count, std::memory_order_relaxed);
+}
+
+void analysis_worker_set_mode(analysis_worker_t *worker, uint32_t mode) {
+    if (mode > ANALYSIS_MODE_CONSTANT_Q) mode = ANALYSIS_MODE_LOG_FFT;
+    worker->mode.store(mode, std::memory_order_relaxed);
+}
+
+void analysis_worker_pass_stats(analysis_worker_t *worker, double *mean_ms, double *max_ms) {
+    uint32_t count = worker->pass_count.load(std::memory_order_acquire);
+    uint64_t total = worker->pass_ns_total.load(std::memory_order_relaxed);
+    *mean_ms = count > 0 ? (double)total / count / 1e6 : 0.0;
+    *max_ms = (double)worker->pass_ns_max.load(std::memory_order_relaxed) / 1e6;
+}
+
+void analysis_worker_push(analysis_worker_t *worker, const float *audio_data, uint32_t frames) {
+    audio_ring_write(&worker->ring, audio_data, frames);
+}
+
+const spectrum_analyzer_t *analysis_worker_latest(analysis_worker_t *worker) {
+    // Swap only when the worker published something newer than what we hold
+    if (worker->shared.load(std::memory_order_relaxed) & ANALYSIS_FRESH) {
+        uint32_t previous = worker->shared.exchange(worker->read_index, std::memory_order_acq_rel);
+        worker->read_index = previous & ~ANALYSIS_FRESH;
+    }
+    return &worker->slots[worker->read_index];
+}
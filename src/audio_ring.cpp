@@ -0,0 +1,82 @@
+#include "audio_ring.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool audio_ring_init(audio_ring_t *ring, uint32_t capacity) {
+    uint32_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    ring->samples = (float *)calloc(size, sizeof(float));
+    if (!ring->samples) return false;
+
+    ring->capacity = size;
+    ring->mask = size - 1;
+    ring->write_pos.store(0, std::memory_order_relaxed);
+    ring->read_pos.store(0, std::memory_order_relaxed);
+    ring->dropped.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void audio_ring_destroy(audio_ring_t *ring) {
+    free(ring->samples);
+    ring->samples = NULL;
+    ring->capacity = 0;
+    ring->mask = 0;
+}
+
+bool audio_ring_write(audio_ring_t *ring, const float *samples, uint32_t frames) {
+    uint32_t write = ring->write_pos.load(std::memory_order_relaxed);
+    uint32_t read = ring->read_pos.load(std::memory_order_acquire);
+
+    if (frames > ring->capacity - (write - read)) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Copy in up to two pieces around the wrap point
+    uint32_t offset = write & ring->mask;
+    uint32_t first = frames < ring->capacity - offset ? frames : ring->capacity - offset;
+    memcpy(ring->samples + offset, samples, first * sizeof(float));
+    memcpy(ring->samples, samples + first, (frames - first) * sizeof(float));
+
+    ring->write_pos.store(write + frames, std::memory_order_release);
+    return true;
+}
+
+uint32_t audio_ring_available(audio_ring_t *ring) {
+    uint32_t write = ring->write_pos.load(std::memory_order_acquire);
+    uint32_t read = ring->read_pos.load(std::memory_order_relaxed);
+    return write - read;
+}
+
+uint32_t audio_ring_read(audio_ring_t *ring, float *samples, uint32_t max_frames) {
+    uint32_t write = ring->write_pos.load(std::memory_order_acquire);
+    uint32_t read = ring->read_pos.load(std::memory_order_relaxed);
+
+    uint32_t frames = write - read;
+    if (frames > max_frames) {
+        frames = max_frames;
+    }
+
+    uint32_t offset = read & ring->mask;
+    uint32_t first = frames < ring->capacity - offset ? frames : ring->capacity - offset;
+    memcpy(samples, ring->samples + offset, first * sizeof(float));
+    memcpy(samples + first, ring->samples, (frames - first) * sizeof(float));
+
+    ring->read_pos.store(read + frames, std::memory_order_release);
+    return frames;
+}
+
+uint32_t audio_ring_skip(audio_ring_t *ring, uint32_t frames) {
+    uint32_t write = ring->write_pos.load(std::memory_order_acquire);
+    uint32_t read = ring->read_pos.load(std::memory_order_relaxed);
+
+    if (frames > write - read) {
+        frames = write - read;
+    }
+
+    ring->read_pos.store(read + frames, std::memory_order_release);
+    return frames;
+}
@@ -0,0 +1,131 @@
+#include "background.h"
+#include "gl_cache.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define BACKGROUND_RESTRICT __restrict
+#else
+#define BACKGROUND_RESTRICT
+#endif
+
+// Phase across the view of the diagonal pattern (0.01 rad per texel of the old 512x512 texture)
+#define BACKGROUND_PATTERN_PHASE 5.12f
+
+// Fullscreen triangle generated from gl_VertexID (no vertex buffers)
+static const char *background_vertex_shader =
+    "#version 330 core\n"
+    "out vec2 v_uv;\n"
+    "void main() {\n"
+    "    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+    "    v_uv = corner;\n"
+    "    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);\n"
+    "}\n";
+
+// Gradient: the clear colour under a band whose colour and alpha rise towards the top.
+// Pattern: blue-on-dark-blue sine along the diagonal, measured from the top-left corner.
+static const char *background_fragment_shader =
+    "#version 330 core\n"
+    "in vec2 v_uv;\n"
+    "uniform float u_pattern;\n"
+    "out vec4 frag_color;\n"
+    "void main() {\n"
+    "    float alpha = 0.1 + 0.1 * v_uv.y;\n"
+    "    vec3 band = vec3(0.0, 0.08 + 0.04 * v_uv.y, 0.16 + 0.08 * v_uv.y);\n"
+    "    vec3 gradient = mix(vec3(0.0, 0.1, 0.2), band, alpha);\n"
+    "    float s = sin(5.12 * (v_uv.x + 1.0 - v_uv.y)) * 0.5 + 0.5;\n"
+    "    vec3 pattern = vec3(0.0, s * 0.25, s);\n"
+    "    frag_color = vec4(mix(gradient, pattern, u_pattern), 1.0);\n"
+    "}\n";
+
+void background_init(background_pass_t *background, float pattern) {
+    memset(background, 0, sizeof(background_pass_t));
+    background->pattern = pattern;
+}
+
+void background_destroy(background_pass_t *background) {
+    if (background->gpu_ready) {
+        glDeleteVertexArrays(1, &background->vao);
+        gl_cache_release_program(background->program);
+    }
+    background_init(background, background->pattern);
+}
+
+static bool background_create_gpu(background_pass_t *background) {
+    if (!gl_ext_load()) return false;
+
+    background->program = gl_cache_acquire_program("background", background_vertex_shader,
+                                                   background_fragment_shader);
+    if (!background->program) return false;
+    background->u_pattern = glGetUniformLocation(background->program, "u_pattern");
+
+    // Core profiles need a bound VAO even without attributes
+    glGenVertexArrays(1, &background->vao);
+    return true;
+}
+
+bool background_draw(background_pass_t *background) {
+    background->draw_calls = 0;
+    background->vertices = 0;
+    if (background->gpu_failed) return false;
+
+    if (!background->gpu_ready) {
+        background->gpu_ready = background_create_gpu(background);
+        background->gpu_failed = !background->gpu_ready;
+        if (!background->gpu_ready) return false;
+    }
+
+    glUseProgram(background->program);
+    glUniform1f(background->u_pattern, background->pattern);
+    glBindVertexArray(background->vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    background->draw_calls = 1;
+    background->vertices = 3;
+    return true;
+}
+
+// One row: pattern sin(a + b) from per-column and per-row sines and cosines, mixed over the row's gradient
+static void background_fill_row(uint8_t *BACKGROUND_RESTRICT dst, const float *BACKGROUND_RESTRICT column_sin,
+                                const float *BACKGROUND_RESTRICT column_cos, uint32_t width,
+                                float row_sin, float row_cos, float gradient_g, float gradient_b, float pattern) {
+    const float keep = 1.0f - pattern;
+    for (size_t i = 0; i < width; i++) {
+        float s = (column_sin[i] * row_cos + column_cos[i] * row_sin) * 0.5f + 0.5f;
+        float g = gradient_g * keep + s * 0.25f * pattern;
+        float b = gradient_b * keep + s * pattern;
+        dst[4 * i + 0] = 0;
+        dst[4 * i + 1] = (uint8_t)(g * 255.0f + 0.5f);
+        dst[4 * i + 2] = (uint8_t)(b * 255.0f + 0.5f);
+        dst[4 * i + 3] = 255;
+    }
+}
+
+void background_fill(const void *user, uint8_t *pixels, uint32_t width, uint32_t height, uint32_t stride) {
+    const background_pass_t *background = (const background_pass_t *)user;
+    float *column_sin = (float *)malloc(2 * (size_t)width * sizeof(float));
+    if (!column_sin) return;
+    float *column_cos = column_sin + width;
+
+    // Pixel centres, as the fragment shader samples them
+    for (uint32_t x = 0; x < width; x++) {
+        float phase = BACKGROUND_PATTERN_PHASE * ((x + 0.5f) / width);
+        column_sin[x] = sinf(phase);
+        column_cos[x] = cosf(phase);
+    }
+
+    for (uint32_t y = 0; y < height; y++) {
+        float up = 1.0f - (y + 0.5f) / height;
+        float alpha = 0.1f + 0.1f * up;
+        float gradient_g = 0.1f + ((0.08f + 0.04f * up) - 0.1f) * alpha;
+        float gradient_b = 0.2f + ((0.16f + 0.08f * up) - 0.2f) * alpha;
+
+        float phase = BACKGROUND_PATTERN_PHASE * (1.0f - up);
+        background_fill_row(pixels + (size_t)y * stride, column_sin, column_cos, width,
+                            sinf(phase), cosf(phase), gradient_g, gradient_b, background->pattern);
+    }
+    free(column_sin);
+}
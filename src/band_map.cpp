@@ -0,0 +1,90 @@
+#include "band_map.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Band edge in fractional bins (bin k covers [k - 0.5, k + 0.5))
+static double band_map_edge(uint32_t index, uint32_t band_count, double min_bin, double max_bin) {
+    return min_bin * pow(max_bin / min_bin, (double)index / (double)band_count);
+}
+
+bool band_map_build(band_map_t *map, uint32_t band_count, uint32_t fft_size, double sample_rate,
+                    float min_hz, float max_hz) {
+    memset(map, 0, sizeof(band_map_t));
+
+    const uint32_t bins = fft_size / 2 + 1;
+    const double bin_hz = sample_rate / fft_size;
+    double max_bin = fmin((double)max_hz, 0.5 * sample_rate) / bin_hz;
+    double min_bin = fmax((double)min_hz / bin_hz, 0.5);
+    if (max_bin <= min_bin) {
+        max_bin = min_bin * 2.0;
+    }
+
+    // Count weights first so the arrays are allocated once
+    uint32_t nonzeros = 0;
+    for (uint32_t b = 0; b < band_count; b++) {
+        double low = band_map_edge(b, band_count, min_bin, max_bin);
+        double high = band_map_edge(b + 1, band_count, min_bin, max_bin);
+        uint32_t first = (uint32_t)floor(low + 0.5);
+        uint32_t last = (uint32_t)floor(high + 0.5);
+        if (last >= bins) last = bins - 1;
+        nonzeros += last - first + 1;
+    }
+
+    map->row_start = (uint32_t *)malloc((band_count + 1) * sizeof(uint32_t));
+    map->columns = (uint32_t *)malloc(nonzeros * sizeof(uint32_t));
+    map->weights = (float *)malloc(nonzeros * sizeof(float));
+    if (!map->row_start || !map->columns || !map->weights) {
+        band_map_destroy(map);
+        return false;
+    }
+
+    uint32_t offset = 0;
+    for (uint32_t b = 0; b < band_count; b++) {
+        double low = band_map_edge(b, band_count, min_bin, max_bin);
+        double high = band_map_edge(b + 1, band_count, min_bin, max_bin);
+        uint32_t first = (uint32_t)floor(low + 0.5);
+        uint32_t last = (uint32_t)floor(high + 0.5);
+        if (last >= bins) last = bins - 1;
+
+        // Wide bands sum the energy they cover; bands narrower than a bin are
+        // normalised so they read the interpolated bin power
+        double scale = 1.0 / fmin(1.0, high - low);
+
+        map->row_start[b] = offset;
+        for (uint32_t k = first; k <= last; k++) {
+            double overlap = fmin(high, k + 0.5) - fmax(low, k - 0.5);
+            map->columns[offset] = k;
+            map->weights[offset] = (float)(fmax(overlap, 0.0) * scale);
+            offset++;
+        }
+    }
+    map->row_start[band_count] = offset;
+
+    map->band_count = band_count;
+    map->fft_size = fft_size;
+    map->sample_rate = sample_rate;
+    map->nonzeros = nonzeros;
+    return true;
+}
+
+void band_map_destroy(band_map_t *map) {
+    free(map->row_start);
+    free(map->columns);
+    free(map->weights);
+    memset(map, 0, sizeof(band_map_t));
+}
+
+void band_map_apply(const band_map_t *map, const float *power, float *bands) {
+    const uint32_t *row_start = map->row_start;
+    const uint32_t *columns = map->columns;
+    const float *weights = map->weights;
+
+    for (uint32_t b = 0; b < map->band_count; b++) {
+        float sum = 0.0f;
+        for (uint32_t i = row_start[b]; i < row_start[b + 1]; i++) {
+            sum += weights[i] * power[columns[i]];
+        }
+        bands[b] = sum;
+    }
+}
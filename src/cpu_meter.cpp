@@ -0,0 +1,123 @@
+#include "cpu_meter.h"
+#include <math.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+uint64_t cpu_meter_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = { 0 };
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1.0e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static uint32_t float_to_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_to_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Map a load fraction to its log bucket
+static uint32_t load_to_bucket(float load) {
+    if (load <= 0.0f) return 0;
+
+    int index = (int)floorf(log2f(load) * CPU_METER_BUCKETS_PER_OCTAVE)
+              - CPU_METER_MIN_OCTAVE * CPU_METER_BUCKETS_PER_OCTAVE;
+    if (index < 0) return 0;
+    if (index >= CPU_METER_BUCKETS) return CPU_METER_BUCKETS - 1;
+    return (uint32_t)index;
+}
+
+// Upper edge of a bucket as a load fraction
+static float bucket_to_load(uint32_t bucket) {
+    return exp2f((float)(bucket + 1) / CPU_METER_BUCKETS_PER_OCTAVE + CPU_METER_MIN_OCTAVE);
+}
+
+void cpu_meter_init(cpu_meter_t *meter) {
+    for (int i = 0; i < CPU_METER_BUCKETS; i++) {
+        meter->buckets[i].store(0, std::memory_order_relaxed);
+    }
+    meter->max_load_bits.store(0, std::memory_order_relaxed);
+    meter->blocks.store(0, std::memory_order_relaxed);
+}
+
+void cpu_meter_record(cpu_meter_t *meter, uint64_t elapsed_ns, uint32_t frames, double sample_rate) {
+    if (frames == 0 || sample_rate <= 0.0) return;
+
+    double budget_ns = (double)frames * 1.0e9 / sample_rate;
+    float load = (float)((double)elapsed_ns / budget_ns);
+
+    // Single writer: plain load/store keeps this wait-free without read-modify-write
+    std::atomic<uint32_t> &bucket = meter->buckets[load_to_bucket(load)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (load > bits_to_float(meter->max_load_bits.load(std::memory_order_relaxed))) {
+        meter->max_load_bits.store(float_to_bits(load), std::memory_order_relaxed);
+    }
+
+    meter->blocks.store(meter->blocks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void cpu_meter_stats_init(cpu_meter_stats_t *stats) {
+    memset(stats, 0, sizeof(cpu_meter_stats_t));
+}
+
+bool cpu_meter_poll(cpu_meter_t *meter, cpu_meter_stats_t *stats) {
+    uint64_t blocks = meter->blocks.load(std::memory_order_acquire);
+    if (blocks == stats->last_blocks) return false;
+
+    // Histogram of the blocks since the previous poll
+    uint32_t delta[CPU_METER_BUCKETS];
+    uint64_t total = 0;
+    for (int i = 0; i < CPU_METER_BUCKETS; i++) {
+        uint32_t count = meter->buckets[i].load(std::memory_order_relaxed);
+        delta[i] = count - stats->last_buckets[i];
+        stats->last_buckets[i] = count;
+        total += delta[i];
+    }
+    stats->last_blocks = blocks;
+    if (total == 0) return false;
+
+    uint64_t p50_rank = (total * 50 + 99) / 100;
+    uint64_t p99_rank = (total * 99 + 99) / 100;
+    uint64_t running = 0;
+    bool have_p50 = false;
+
+    for (int i = 0; i < CPU_METER_BUCKETS; i++) {
+        running += delta[i];
+        if (!have_p50 && running >= p50_rank) {
+            stats->p50 = bucket_to_load(i);
+            have_p50 = true;
+        }
+        if (running >= p99_rank) {
+            stats->p99 = bucket_to_load(i);
+            break;
+        }
+    }
+
+    stats->max = bits_to_float(meter->max_load_bits.exchange(0, std::memory_order_relaxed));
+    return true;
+}
@@ -0,0 +1,160 @@
+#include "cqt.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool cqt_kernel_build(cqt_kernel_t *kernel, uint32_t band_count, uint32_t bins_per_octave,
+                      uint32_t fft_size, double sample_rate) {
+    memset(kernel, 0, sizeof(cqt_kernel_t));
+
+    const uint32_t bins = fft_size / 2 + 1;
+    const double q = 1.0 / (pow(2.0, 1.0 / bins_per_octave) - 1.0);
+
+    // Lowest band on the reference grid whose kernel still fits into the frame
+    double lowest = q * sample_rate / fft_size;
+    double steps = ceil(bins_per_octave * log2(fmax(lowest, (double)CQT_REFERENCE_HZ) / CQT_REFERENCE_HZ) - 1e-9);
+    double min_hz = CQT_REFERENCE_HZ * pow(2.0, steps / bins_per_octave);
+    double max_hz = CQT_MAX_HZ_FRACTION * sample_rate;
+
+    fft_plan_t plan;
+    float *temporal = (float *)malloc(2 * fft_size * sizeof(float));
+    float *spectrum = (float *)malloc(4 * bins * sizeof(float));
+    float *magnitude = (float *)malloc(bins * sizeof(float));
+
+    // Rows are built into bin-sized scratch and then packed
+    uint32_t capacity = bins;
+    kernel->row_start = (uint32_t *)malloc((band_count + 1) * sizeof(uint32_t));
+    kernel->columns = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+    kernel->kernel_re = (float *)malloc(capacity * sizeof(float));
+    kernel->kernel_im = (float *)malloc(capacity * sizeof(float));
+
+    bool ok = temporal && spectrum && magnitude && kernel->row_start && kernel->columns &&
+              kernel->kernel_re && kernel->kernel_im && fft_plan_init(&plan, fft_size);
+    if (!ok) {
+        free(temporal);
+        free(spectrum);
+        free(magnitude);
+        cqt_kernel_destroy(kernel);
+        return false;
+    }
+
+    float *temporal_re = temporal;
+    float *temporal_im = temporal + fft_size;
+    float *real_re = spectrum;
+    float *real_im = spectrum + bins;
+    float *imag_re = spectrum + 2 * bins;
+    float *imag_im = spectrum + 3 * bins;
+
+    uint32_t offset = 0;
+    for (uint32_t b = 0; b < band_count; b++) {
+        kernel->row_start[b] = offset;
+
+        double frequency = min_hz * pow(2.0, (double)b / bins_per_octave);
+        if (frequency > max_hz) continue;
+
+        // Hann-windowed exponential, centred. The gain is taken over the kernel window
+        // times the frame's own Hann window, so a sine reads like the FFT path.
+        uint32_t length = (uint32_t)ceil(q * sample_rate / frequency);
+        if (length > fft_size) length = fft_size;
+        uint32_t start = (fft_size - length) / 2;
+
+        memset(temporal, 0, 2 * fft_size * sizeof(float));
+        double window_sum = 0.0;
+        for (uint32_t n = 0; n < length; n++) {
+            double frame_window = 0.5 - 0.5 * cos(2.0 * M_PI * (start + n) / fft_size);
+            window_sum += (0.5 - 0.5 * cos(2.0 * M_PI * n / length)) * frame_window;
+        }
+        for (uint32_t n = 0; n < length; n++) {
+            double window = (0.5 - 0.5 * cos(2.0 * M_PI * n / length)) * 0.5 / window_sum;
+            double phase = 2.0 * M_PI * frequency * (double)n / sample_rate;
+            temporal_re[start + n] = (float)(window * cos(phase));
+            temporal_im[start + n] = (float)(window * sin(phase));
+        }
+
+        // Complex kernel spectrum from two real transforms: K = FFT(re) + i * FFT(im)
+        fft_real_forward(&plan, temporal_re, real_re, real_im);
+        fft_real_forward(&plan, temporal_im, imag_re, imag_im);
+
+        float peak = 0.0f;
+        for (uint32_t k = 0; k < bins; k++) {
+            float kr = real_re[k] - imag_im[k];
+            float ki = real_im[k] + imag_re[k];
+            real_re[k] = kr;
+            real_im[k] = ki;
+            magnitude[k] = sqrtf(kr * kr + ki * ki);
+            peak = fmaxf(peak, magnitude[k]);
+        }
+
+        // Keep only the significant part of the kernel, stored conjugated with the 1/N of Parseval
+        float threshold = peak * CQT_KERNEL_THRESHOLD;
+        for (uint32_t k = 0; k < bins; k++) {
+            if (magnitude[k] < threshold) continue;
+
+            if (offset == capacity) {
+                capacity *= 2;
+                uint32_t *columns = (uint32_t *)realloc(kernel->columns, capacity * sizeof(uint32_t));
+                if (columns) kernel->columns = columns;
+                float *kernel_re = (float *)realloc(kernel->kernel_re, capacity * sizeof(float));
+                if (kernel_re) kernel->kernel_re = kernel_re;
+                float *kernel_im = (float *)realloc(kernel->kernel_im, capacity * sizeof(float));
+                if (kernel_im) kernel->kernel_im = kernel_im;
+                if (!columns || !kernel_re || !kernel_im) {
+                    ok = false;
+                    break;
+                }
+            }
+
+            kernel->columns[offset] = k;
+            kernel->kernel_re[offset] = real_re[k] / fft_size;
+            kernel->kernel_im[offset] = -real_im[k] / fft_size;
+            offset++;
+        }
+        if (!ok) break;
+    }
+
+    fft_plan_destroy(&plan);
+    free(temporal);
+    free(spectrum);
+    free(magnitude);
+
+    if (!ok) {
+        cqt_kernel_destroy(kernel);
+        return false;
+    }
+
+    kernel->row_start[band_count] = offset;
+    kernel->band_count = band_count;
+    kernel->fft_size = fft_size;
+    kernel->sample_rate = sample_rate;
+    kernel->bins_per_octave = bins_per_octave;
+    kernel->min_hz = (float)min_hz;
+    kernel->nonzeros = offset;
+    return true;
+}
+
+void cqt_kernel_destroy(cqt_kernel_t *kernel) {
+    free(kernel->row_start);
+    free(kernel->columns);
+    free(kernel->kernel_re);
+    free(kernel->kernel_im);
+    memset(kernel, 0, sizeof(cqt_kernel_t));
+}
+
+void cqt_kernel_accumulate(const cqt_kernel_t *kernel, const float *re, const float *im, float *band_power) {
+    const uint32_t *row_start = kernel->row_start;
+    const uint32_t *columns = kernel->columns;
+    const float *kernel_re = kernel->kernel_re;
+    const float *kernel_im = kernel->kernel_im;
+
+    for (uint32_t b = 0; b < kernel->band_count; b++) {
+        float sum_re = 0.0f;
+        float sum_im = 0.0f;
+        for (uint32_t i = row_start[b]; i < row_start[b + 1]; i++) {
+            float xr = re[columns[i]];
+            float xi = im[columns[i]];
+            sum_re += xr * kernel_re[i] - xi * kernel_im[i];
+            sum_im += xr * kernel_im[i] + xi * kernel_re[i];
+        }
+        band_power[b] += sum_re * sum_re + sum_im * sum_im;
+    }
+}
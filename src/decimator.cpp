@@ -0,0 +1,106 @@
+#include "decimator.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define DECIMATOR_RESTRICT __restrict
+#else
+#define DECIMATOR_RESTRICT
+#endif
+
+// Lane count of the partial sums (taps are always a multiple of it)
+#define DECIMATOR_LANES 8
+
+uint32_t decimator_factor_for_rate(double sample_rate, double min_rate) {
+    uint32_t factor = (uint32_t)(sample_rate / min_rate);
+    if (factor < 1) factor = 1;
+    if (factor > DECIMATOR_MAX_FACTOR) factor = DECIMATOR_MAX_FACTOR;
+    return factor;
+}
+
+bool decimator_init(decimator_t *decimator, uint32_t factor) {
+    memset(decimator, 0, sizeof(decimator_t));
+
+    if (factor < 1) factor = 1;
+    if (factor > DECIMATOR_MAX_FACTOR) factor = DECIMATOR_MAX_FACTOR;
+
+    uint32_t taps = factor * DECIMATOR_TAPS_PER_PHASE;
+    float *block = (float *)calloc(taps + (taps - 1) + DECIMATOR_BLOCK, sizeof(float));
+    if (!block) {
+        return false;
+    }
+
+    decimator->factor = factor;
+    decimator->taps = taps;
+    decimator->coefficients = block;
+    decimator->buffer = block + taps;
+
+    // Windowed sinc with cutoff at half the output rate, normalised to unity DC gain
+    double cutoff = 0.5 / factor;
+    double centre = 0.5 * (taps - 1);
+    double sum = 0.0;
+    for (uint32_t i = 0; i < taps; i++) {
+        double t = i - centre;
+        double sinc = fabs(t) < 1e-9 ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        double window = 0.42 - 0.5 * cos(2.0 * M_PI * (i + 0.5) / taps) + 0.08 * cos(4.0 * M_PI * (i + 0.5) / taps);
+        decimator->coefficients[i] = (float)(sinc * window);
+        sum += sinc * window;
+    }
+    for (uint32_t i = 0; i < taps; i++) {
+        decimator->coefficients[i] = (float)(decimator->coefficients[i] / sum);
+    }
+
+    return true;
+}
+
+void decimator_destroy(decimator_t *decimator) {
+    free(decimator->coefficients);
+    memset(decimator, 0, sizeof(decimator_t));
+}
+
+static inline float decimator_dot(const float *DECIMATOR_RESTRICT coefficients,
+                                  const float *DECIMATOR_RESTRICT samples, uint32_t taps) {
+    float lanes[DECIMATOR_LANES] = {0};
+    for (uint32_t i = 0; i < taps; i += DECIMATOR_LANES) {
+        for (uint32_t l = 0; l < DECIMATOR_LANES; l++) {
+            lanes[l] += coefficients[i + l] * samples[i + l];
+        }
+    }
+
+    float sum = 0.0f;
+    for (uint32_t l = 0; l < DECIMATOR_LANES; l++) {
+        sum += lanes[l];
+    }
+    return sum;
+}
+
+uint32_t decimator_process(decimator_t *decimator, const float *input, uint32_t count, float *output) {
+    if (decimator->factor == 1) {
+        memcpy(output, input, count * sizeof(float));
+        return count;
+    }
+
+    const uint32_t factor = decimator->factor;
+    const uint32_t taps = decimator->taps;
+    float *buffer = decimator->buffer;
+    uint32_t produced = 0;
+
+    while (count > 0) {
+        uint32_t chunk = count < DECIMATOR_BLOCK ? count : DECIMATOR_BLOCK;
+        memcpy(buffer + taps - 1, input, chunk * sizeof(float));
+
+        // Output for input sample i uses the taps samples ending at it
+        uint32_t i = decimator->next;
+        for (; i < chunk; i += factor) {
+            output[produced++] = decimator_dot(decimator->coefficients, buffer + i, taps);
+        }
+        decimator->next = i - chunk;
+
+        memmove(buffer, buffer + chunk, (taps - 1) * sizeof(float));
+        input += chunk;
+        count -= chunk;
+    }
+
+    return produced;
+}
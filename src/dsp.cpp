@@ -254,4 +254,245 @@ void filter_get_frequency_response(filter_t *filter, float frequency, float *mag
     float num_phase = atan2f(num_imag, num_real);
     float den_phase = atan2f(den_imag, den_real);
     *phase_deg = (num_phase - den_phase) * 180.0f / M_PI;
-}
\ No newline at end of file
+}
+
+// Biquad step specialised on the structural zeros of each filter type.
+// Lowpass/highpass: b0 == b2, b1 == +/-2*b0. Band-pass: b1 == 0, b2 == -b0.
+// Notch: b0 == b2, b1 == a1. Peaking: b1 == a1. Shelves use the full form.
+template <filter_type_t Type>
+static inline float biquad_step(const filter_t *f, float x, float x1, float x2, float y1, float y2) {
+    switch (Type) {
+        case FILTER_TYPE_LOWPASS:
+            return f->b0 * (x + x1 + x1 + x2) - f->a1 * y1 - f->a2 * y2;
+        case FILTER_TYPE_HIGHPASS:
+            return f->b0 * (x - x1 - x1 + x2) - f->a1 * y1 - f->a2 * y2;
+        case FILTER_TYPE_BANDPASS:
+            return f->b0 * (x - x2) - f->a1 * y1 - f->a2 * y2;
+        case FILTER_TYPE_NOTCH:
+            return f->b0 * (x + x2) + f->a1 * (x1 - y1) - f->a2 * y2;
+        case FILTER_TYPE_PEAKING:
+            return f->b0 * x + f->b2 * x2 + f->a1 * (x1 - y1) - f->a2 * y2;
+        default:
+            return f->b0 * x + f->b1 * x1 + f->b2 * x2 - f->a1 * y1 - f->a2 * y2;
+    }
+}
+
+// Block kernel for a fixed filter type, channel count and section count.
+// Channels == 0 selects the generic path for channel counts without a specialisation.
+template <filter_type_t Type, uint32_t Channels, uint32_t Sections>
+static void biquad_kernel(filter_bank_t *bank, const float *const *inputs, float *const *outputs, uint32_t frames) {
+    const filter_t *f = &bank->filter;
+    const uint32_t channels = Channels ? Channels : bank->channels;
+    
+    // Work on local copies of the delays so they stay in registers
+    float x1[Sections][Channels ? Channels : FILTER_MAX_CHANNELS];
+    float x2[Sections][Channels ? Channels : FILTER_MAX_CHANNELS];
+    float y1[Sections][Channels ? Channels : FILTER_MAX_CHANNELS];
+    float y2[Sections][Channels ? Channels : FILTER_MAX_CHANNELS];
+    
+    for (uint32_t s = 0; s < Sections; ++s) {
+        for (uint32_t ch = 0; ch < channels; ++ch) {
+            x1[s][ch] = bank->x1[s][ch];
+            x2[s][ch] = bank->x2[s][ch];
+            y1[s][ch] = bank->y1[s][ch];
+            y2[s][ch] = bank->y2[s][ch];
+        }
+    }
+    
+    for (uint32_t i = 0; i < frames; ++i) {
+        for (uint32_t ch = 0; ch < channels; ++ch) {
+            float value = inputs[ch][i];
+            
+            for (uint32_t s = 0; s < Sections; ++s) {
+                float output = biquad_step<Type>(f, value, x1[s][ch], x2[s][ch], y1[s][ch], y2[s][ch]);
+                x2[s][ch] = x1[s][ch];
+                x1[s][ch] = value;
+                y2[s][ch] = y1[s][ch];
+                y1[s][ch] = output;
+                value = output;
+            }
+            
+            outputs[ch][i] = value;
+        }
+    }
+    
+    for (uint32_t s = 0; s < Sections; ++s) {
+        for (uint32_t ch = 0; ch < channels; ++ch) {
+            bank->x1[s][ch] = x1[s][ch];
+            bank->x2[s][ch] = x2[s][ch];
+            bank->y1[s][ch] = y1[s][ch];
+            bank->y2[s][ch] = y2[s][ch];
+        }
+    }
+}
+
+// Dispatch table: [filter type][channel slot][section count - 1]
+// Channel slots: 0 = generic, 1 = mono, 2 = stereo, 3 = quad, 4 = 8 channels
+#define FILTER_KERNEL_SECTIONS(T, C) \
+    { biquad_kernel<T, C, 1>, biquad_kernel<T, C, 2>, biquad_kernel<T, C, 3>, biquad_kernel<T, C, 4> }
+#define FILTER_KERNEL_CHANNELS(T) \
+    { FILTER_KERNEL_SECTIONS(T, 0), FILTER_KERNEL_SECTIONS(T, 1), FILTER_KERNEL_SECTIONS(T, 2), \
+      FILTER_KERNEL_SECTIONS(T, 4), FILTER_KERNEL_SECTIONS(T, 8) }
+
+static const filter_kernel_fn filter_kernel_table[7][5][FILTER_MAX_SECTIONS] = {
+    FILTER_KERNEL_CHANNELS(FILTER_TYPE_LOWPASS),
+    FILTER_KERNEL_CHANNELS(FILTER_TYPE_HIGHPASS),
+    FILTER_KERNEL_CHANNELS(FILTER_TYPE_BANDPASS),
+    FILTER_KERNEL_CHANNELS(FILTER_TYPE_NOTCH),
+    FILTER_KERNEL_CHANNELS(FILTER_TYPE_PEAKING),
+    FILTER_KERNEL_CHANNELS(FILTER_TYPE_LOWSHELF),
+    FILTER_KERNEL_CHANNELS(FILTER_TYPE_HIGHSHELF)
+};
+
+#undef FILTER_KERNEL_CHANNELS
+#undef FILTER_KERNEL_SECTIONS
+
+// Mid/side kernel for a stereo bank: encode, filter one path, decode in a single
+// pass over the left/right buffers (in place is fine). The filtered path keeps
+// its delays in the channel 0 slot.
+template <filter_type_t Type, uint32_t Sections, bool Mid>
+static void mid_side_kernel(filter_bank_t *bank, const float *const *inputs, float *const *outputs, uint32_t frames) {
+    const filter_t *f = &bank->filter;
+    const float *left = inputs[0];
+    const float *right = inputs[1];
+    float *out_left = outputs[0];
+    float *out_right = outputs[1];
+    
+    float x1[Sections], x2[Sections], y1[Sections], y2[Sections];
+    for (uint32_t s = 0; s < Sections; ++s) {
+        x1[s] = bank->x1[s][0];
+        x2[s] = bank->x2[s][0];
+        y1[s] = bank->y1[s][0];
+        y2[s] = bank->y2[s][0];
+    }
+    
+    for (uint32_t i = 0; i < frames; ++i) {
+        float mid = 0.5f * (left[i] + right[i]);
+        float side = 0.5f * (left[i] - right[i]);
+        float value = Mid ? mid : side;
+        
+        for (uint32_t s = 0; s < Sections; ++s) {
+            float output = biquad_step<Type>(f, value, x1[s], x2[s], y1[s], y2[s]);
+            x2[s] = x1[s];
+            x1[s] = value;
+            y2[s] = y1[s];
+            y1[s] = output;
+            value = output;
+        }
+        
+        if (Mid) mid = value; else side = value;
+        out_left[i] = mid + side;
+        out_right[i] = mid - side;
+    }
+    
+    for (uint32_t s = 0; s < Sections; ++s) {
+        bank->x1[s][0] = x1[s];
+        bank->x2[s][0] = x2[s];
+        bank->y1[s][0] = y1[s];
+        bank->y2[s][0] = y2[s];
+    }
+}
+
+// Dispatch table: [filter type][mid, side][section count - 1]
+#define MID_SIDE_KERNEL_SECTIONS(T, M) \
+    { mid_side_kernel<T, 1, M>, mid_side_kernel<T, 2, M>, mid_side_kernel<T, 3, M>, mid_side_kernel<T, 4, M> }
+#define MID_SIDE_KERNEL_PATHS(T) \
+    { MID_SIDE_KERNEL_SECTIONS(T, true), MID_SIDE_KERNEL_SECTIONS(T, false) }
+
+static const filter_kernel_fn mid_side_kernel_table[7][2][FILTER_MAX_SECTIONS] = {
+    MID_SIDE_KERNEL_PATHS(FILTER_TYPE_LOWPASS),
+    MID_SIDE_KERNEL_PATHS(FILTER_TYPE_HIGHPASS),
+    MID_SIDE_KERNEL_PATHS(FILTER_TYPE_BANDPASS),
+    MID_SIDE_KERNEL_PATHS(FILTER_TYPE_NOTCH),
+    MID_SIDE_KERNEL_PATHS(FILTER_TYPE_PEAKING),
+    MID_SIDE_KERNEL_PATHS(FILTER_TYPE_LOWSHELF),
+    MID_SIDE_KERNEL_PATHS(FILTER_TYPE_HIGHSHELF)
+};
+
+#undef MID_SIDE_KERNEL_PATHS
+#undef MID_SIDE_KERNEL_SECTIONS
+
+static uint32_t filter_kernel_channel_slot(uint32_t channels) {
+    switch (channels) {
+        case 1: return 1;
+        case 2: return 2;
+        case 4: return 3;
+        case 8: return 4;
+        default: return 0;
+    }
+}
+
+// Recalculate coefficients and pick the matching kernel
+static void filter_bank_update(filter_bank_t *bank) {
+    calculate_biquad_coefficients(&bank->filter);
+    bank->filter.initialized = true;
+    
+    uint32_t type = (uint32_t)bank->filter.type;
+    if (type > FILTER_TYPE_HIGHSHELF) type = FILTER_TYPE_LOWPASS;
+    
+    if (bank->channels == 2 && bank->channel_mode != FILTER_CHANNEL_MODE_STEREO) {
+        uint32_t path = bank->channel_mode == FILTER_CHANNEL_MODE_MID ? 0 : 1;
+        bank->kernel = mid_side_kernel_table[type][path][bank->sections - 1];
+        return;
+    }
+    bank->kernel = filter_kernel_table[type][filter_kernel_channel_slot(bank->channels)][bank->sections - 1];
+}
+
+void filter_bank_init(filter_bank_t *bank, filter_type_t type, float cutoff_freq, float resonance, float gain,
+                      float sample_rate, uint32_t channels, uint32_t sections) {
+    memset(bank, 0, sizeof(filter_bank_t));
+    
+    filter_init(&bank->filter, type, cutoff_freq, resonance, gain, sample_rate);
+    bank->channels = (uint32_t)clampf((float)channels, 1.0f, (float)FILTER_MAX_CHANNELS);
+    bank->sections = (uint32_t)clampf((float)sections, 1.0f, (float)FILTER_MAX_SECTIONS);
+    
+    filter_bank_update(bank);
+}
+
+void filter_bank_set_parameters(filter_bank_t *bank, filter_type_t type, float cutoff_freq, float resonance, float gain) {
+    filter_t *filter = &bank->filter;
+    
+    if (filter->initialized && filter->type == type && filter->cutoff_freq == cutoff_freq &&
+        filter->resonance == resonance && filter->gain == gain) {
+        return;
+    }
+    
+    filter->type = type;
+    filter->cutoff_freq = cutoff_freq;
+    filter->resonance = resonance;
+    filter->gain = gain;
+    
+    filter_bank_update(bank);
+}
+
+void filter_bank_set_sample_rate(filter_bank_t *bank, float sample_rate) {
+    if (bank->filter.initialized && bank->filter.sample_rate == sample_rate) return;
+    
+    bank->filter.sample_rate = sample_rate;
+    filter_bank_update(bank);
+}
+
+void filter_bank_set_channel_mode(filter_bank_t *bank, filter_channel_mode_t mode) {
+    if (mode > FILTER_CHANNEL_MODE_SIDE) mode = FILTER_CHANNEL_MODE_STEREO;
+    if (bank->channel_mode == mode) return;
+    
+    // Delays of one routing mean nothing to the other
+    bank->channel_mode = mode;
+    filter_bank_reset(bank);
+    filter_bank_update(bank);
+}
+
+void filter_bank_process(filter_bank_t *bank, const float *const *inputs, float *const *outputs, uint32_t frames) {
+    if (!bank->kernel) {
+        filter_bank_update(bank);
+    }
+    
+    bank->kernel(bank, inputs, outputs, frames);
+}
+
+void filter_bank_reset(filter_bank_t *bank) {
+    memset(bank->x1, 0, sizeof(bank->x1));
+    memset(bank->x2, 0, sizeof(bank->x2));
+    memset(bank->y1, 0, sizeof(bank->y1));
+    memset(bank->y2, 0, sizeof(bank->y2));
+}
@@ -0,0 +1,192 @@
+#include "fft.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define FFT_RESTRICT __restrict
+#else
+#define FFT_RESTRICT
+#endif
+
+bool fft_plan_init(fft_plan_t *plan, uint32_t size) {
+    memset(plan, 0, sizeof(fft_plan_t));
+
+    if (size < FFT_MIN_SIZE || size > FFT_MAX_SIZE || (size & (size - 1)) != 0) {
+        return false;
+    }
+
+    uint32_t half = size / 2;
+    uint32_t half_log2 = 0;
+    while ((1u << half_log2) < half) {
+        half_log2++;
+    }
+
+    plan->size = size;
+    plan->half = half;
+    plan->half_log2 = half_log2;
+    plan->bitrev = (uint32_t *)malloc(half * sizeof(uint32_t));
+    plan->twiddle_re = (float *)malloc(half * sizeof(float));
+    plan->twiddle_im = (float *)malloc(half * sizeof(float));
+    plan->post_re = (float *)malloc((half / 2 + 1) * sizeof(float));
+    plan->post_im = (float *)malloc((half / 2 + 1) * sizeof(float));
+
+    if (!plan->bitrev || !plan->twiddle_re || !plan->twiddle_im || !plan->post_re || !plan->post_im) {
+        fft_plan_destroy(plan);
+        return false;
+    }
+
+    // Input permutation for the decimation-in-time passes
+    for (uint32_t i = 0; i < half; i++) {
+        uint32_t reversed = 0;
+        for (uint32_t bit = 0; bit < half_log2; bit++) {
+            reversed |= ((i >> bit) & 1u) << (half_log2 - 1 - bit);
+        }
+        plan->bitrev[i] = reversed;
+    }
+
+    // Radix-4 stage twiddles in the order fft_complex() consumes them (3 * length per stage)
+    uint32_t offset = 0;
+    for (uint32_t length = (half_log2 & 1) ? 2 : 1; length < half; length *= 4) {
+        for (uint32_t k = 1; k <= 3; k++) {
+            for (uint32_t j = 0; j < length; j++) {
+                double angle = -2.0 * M_PI * (double)(k * j) / (double)(4 * length);
+                plan->twiddle_re[offset] = (float)cos(angle);
+                plan->twiddle_im[offset] = (float)sin(angle);
+                offset++;
+            }
+        }
+    }
+
+    // Real-to-complex post-processing twiddles
+    for (uint32_t k = 0; k <= half / 2; k++) {
+        double angle = -2.0 * M_PI * (double)k / (double)size;
+        plan->post_re[k] = (float)cos(angle);
+        plan->post_im[k] = (float)sin(angle);
+    }
+
+    return true;
+}
+
+void fft_plan_destroy(fft_plan_t *plan) {
+    free(plan->bitrev);
+    free(plan->twiddle_re);
+    free(plan->twiddle_im);
+    free(plan->post_re);
+    free(plan->post_im);
+    memset(plan, 0, sizeof(fft_plan_t));
+}
+
+// In-place complex FFT of bit-reversed split data
+static void fft_complex(const fft_plan_t *plan, float *FFT_RESTRICT re, float *FFT_RESTRICT im) {
+    const uint32_t n = plan->half;
+    uint32_t length = 1;
+
+    // Odd number of radix-2 stages: do one plain radix-2 pass first
+    if (plan->half_log2 & 1) {
+        for (uint32_t i = 0; i < n; i += 2) {
+            float ar = re[i], ai = im[i];
+            float br = re[i + 1], bi = im[i + 1];
+            re[i] = ar + br;
+            im[i] = ai + bi;
+            re[i + 1] = ar - br;
+            im[i + 1] = ai - bi;
+        }
+        length = 2;
+    }
+
+    const float *twiddle_re = plan->twiddle_re;
+    const float *twiddle_im = plan->twiddle_im;
+
+    // Each radix-4 pass fuses two radix-2 stages: four length-L sub-transforms become one of 4L
+    for (; length < n; length *= 4) {
+        const float *FFT_RESTRICT w1r = twiddle_re;
+        const float *FFT_RESTRICT w2r = twiddle_re + length;
+        const float *FFT_RESTRICT w3r = twiddle_re + 2 * length;
+        const float *FFT_RESTRICT w1i = twiddle_im;
+        const float *FFT_RESTRICT w2i = twiddle_im + length;
+        const float *FFT_RESTRICT w3i = twiddle_im + 2 * length;
+
+        for (uint32_t block = 0; block < n; block += 4 * length) {
+            float *FFT_RESTRICT r0 = re + block;
+            float *FFT_RESTRICT r1 = r0 + length;
+            float *FFT_RESTRICT r2 = r1 + length;
+            float *FFT_RESTRICT r3 = r2 + length;
+            float *FFT_RESTRICT i0 = im + block;
+            float *FFT_RESTRICT i1 = i0 + length;
+            float *FFT_RESTRICT i2 = i1 + length;
+            float *FFT_RESTRICT i3 = i2 + length;
+
+            for (uint32_t j = 0; j < length; j++) {
+                float br = r1[j] * w2r[j] - i1[j] * w2i[j];
+                float bi = r1[j] * w2i[j] + i1[j] * w2r[j];
+                float cr = r2[j] * w1r[j] - i2[j] * w1i[j];
+                float ci = r2[j] * w1i[j] + i2[j] * w1r[j];
+                float dr = r3[j] * w3r[j] - i3[j] * w3i[j];
+                float di = r3[j] * w3i[j] + i3[j] * w3r[j];
+
+                float s0r = r0[j] + br, s0i = i0[j] + bi;
+                float s1r = r0[j] - br, s1i = i0[j] - bi;
+                float t0r = cr + dr, t0i = ci + di;
+                float t1r = cr - dr, t1i = ci - di;
+
+                r0[j] = s0r + t0r;
+                i0[j] = s0i + t0i;
+                r2[j] = s0r - t0r;
+                i2[j] = s0i - t0i;
+                // (s1 - i * t1) and (s1 + i * t1)
+                r1[j] = s1r + t1i;
+                i1[j] = s1i - t1r;
+                r3[j] = s1r - t1i;
+                i3[j] = s1i + t1r;
+            }
+        }
+
+        twiddle_re += 3 * length;
+        twiddle_im += 3 * length;
+    }
+}
+
+void fft_real_forward(const fft_plan_t *plan, const float *input, float *out_re, float *out_im) {
+    const uint32_t n = plan->half;
+
+    // Pack even/odd samples as re/im, permuted for the DIT passes
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t source = plan->bitrev[i] * 2;
+        out_re[i] = input[source];
+        out_im[i] = input[source + 1];
+    }
+
+    fft_complex(plan, out_re, out_im);
+
+    // Split Z[k] into the spectra of the even and odd samples and combine:
+    // X[k] = (Z[k] + Z*[n-k]) / 2 - i * W^k * (Z[k] - Z*[n-k]) / 2, computed pairwise in place
+    float z0r = out_re[0];
+    float z0i = out_im[0];
+    out_re[0] = z0r + z0i;
+    out_im[0] = 0.0f;
+    out_re[n] = z0r - z0i;
+    out_im[n] = 0.0f;
+
+    for (uint32_t k = 1; k <= n / 2; k++) {
+        uint32_t m = n - k;
+        float ar = out_re[k], ai = out_im[k];
+        float br = out_re[m], bi = out_im[m];
+
+        float even_r = 0.5f * (ar + br);
+        float even_i = 0.5f * (ai - bi);
+        float odd_r = 0.5f * (ai + bi);
+        float odd_i = -0.5f * (ar - br);
+
+        // W^k for bin k; bin n-k uses W^(n-k) = -conj(W^k)
+        float wr = plan->post_re[k];
+        float wi = plan->post_im[k];
+        float rotated_r = wr * odd_r - wi * odd_i;
+        float rotated_i = wr * odd_i + wi * odd_r;
+
+        out_re[k] = even_r + rotated_r;
+        out_im[k] = even_i + rotated_i;
+        out_re[m] = even_r - rotated_r;
+        out_im[m] = -(even_i - rotated_i);
+    }
+}
@@ -0,0 +1,78 @@
+#include "frame_scheduler.h"
+#include <string.h>
+
+static uint64_t frame_scheduler_interval(double hz) {
+    if (hz < 1.0) hz = 1.0;
+    return (uint64_t)(1.0e9 / hz);
+}
+
+static uint64_t frame_scheduler_current_interval(const frame_scheduler_t *scheduler) {
+    return scheduler->idle ? frame_scheduler_interval(FRAME_SCHEDULER_IDLE_HZ) : scheduler->active_interval_ns;
+}
+
+void frame_scheduler_init(frame_scheduler_t *scheduler, double refresh_hz) {
+    memset(scheduler, 0, sizeof(frame_scheduler_t));
+    scheduler->active_interval_ns = frame_scheduler_interval(refresh_hz);
+    scheduler->visible = true;
+}
+
+void frame_scheduler_set_refresh_rate(frame_scheduler_t *scheduler, double refresh_hz) {
+    scheduler->active_interval_ns = frame_scheduler_interval(refresh_hz);
+    if (scheduler->last_frame_ns != 0) {
+        scheduler->next_frame_ns = scheduler->last_frame_ns + frame_scheduler_current_interval(scheduler);
+    }
+}
+
+void frame_scheduler_set_visible(frame_scheduler_t *scheduler, bool visible) {
+    if (visible && !scheduler->visible) {
+        scheduler->last_frame_ns = 0;
+    }
+    scheduler->visible = visible;
+}
+
+void frame_scheduler_set_idle(frame_scheduler_t *scheduler, bool idle) {
+    if (idle == scheduler->idle) return;
+
+    scheduler->idle = idle;
+    if (scheduler->last_frame_ns != 0) {
+        scheduler->next_frame_ns = scheduler->last_frame_ns + frame_scheduler_current_interval(scheduler);
+    }
+}
+
+bool frame_scheduler_begin(frame_scheduler_t *scheduler, uint64_t now_ns, float *delta_time) {
+    if (!scheduler->visible) return false;
+
+    uint64_t interval = frame_scheduler_current_interval(scheduler);
+
+    // First frame of a timeline: step by one nominal interval
+    if (scheduler->last_frame_ns == 0) {
+        scheduler->last_frame_ns = now_ns;
+        scheduler->next_frame_ns = now_ns + interval;
+        *delta_time = (float)(interval * 1.0e-9);
+        return true;
+    }
+
+    if (now_ns + FRAME_SCHEDULER_SLACK_NS < scheduler->next_frame_ns) return false;
+
+    // Deadlines advance by whole intervals so the long-run rate never exceeds
+    // the cap; after falling behind by more than one frame, resynchronise
+    scheduler->next_frame_ns += interval;
+    if (scheduler->next_frame_ns < now_ns) {
+        scheduler->next_frame_ns = now_ns + interval;
+    }
+
+    float step = (float)((now_ns - scheduler->last_frame_ns) * 1.0e-9);
+    scheduler->last_frame_ns = now_ns;
+    *delta_time = step < FRAME_SCHEDULER_MAX_STEP ? step : FRAME_SCHEDULER_MAX_STEP;
+    return true;
+}
+
+uint32_t frame_scheduler_wait_ms(const frame_scheduler_t *scheduler, uint64_t now_ns) {
+    // Hidden editors are woken by set_visible; poll at the idle rate meanwhile
+    if (!scheduler->visible) return (uint32_t)(frame_scheduler_interval(FRAME_SCHEDULER_IDLE_HZ) / 1000000);
+    if (scheduler->last_frame_ns == 0) return 1;
+
+    uint64_t due = scheduler->next_frame_ns - FRAME_SCHEDULER_SLACK_NS;
+    if (now_ns >= due) return 1;
+    return (uint32_t)((due - now_ns + 999999) / 1000000);
+}
@@ -0,0 +1,285 @@
+#include "gl_cache.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <OpenGL/OpenGL.h>
+#else
+#include <GL/glx.h>
+#endif
+
+typedef struct {
+    void *context;
+    uint32_t group;
+    bool joined;     // registered by the editor (not discovered on first use)
+} gl_cache_context_t;
+
+typedef struct {
+    const char *key;
+    uint32_t group;
+    bool texture;
+    GLuint name;
+    uint32_t references;
+} gl_cache_entry_t;
+
+// Built pixel data, kept for the life of the process
+typedef struct {
+    const char *key;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint8_t *pixels;
+} gl_cache_pixels_t;
+
+static pthread_mutex_t gl_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static gl_cache_context_t gl_cache_contexts[GL_CACHE_MAX_CONTEXTS];
+static uint32_t gl_cache_context_count = 0;
+static gl_cache_entry_t gl_cache_entries[GL_CACHE_MAX_ENTRIES];
+static uint32_t gl_cache_entry_count = 0;
+static gl_cache_pixels_t gl_cache_pixels[GL_CACHE_MAX_PIXELS];
+static uint32_t gl_cache_pixels_count = 0;
+static uint32_t gl_cache_next_group = 1;
+
+void *gl_cache_current_context(void) {
+#if defined(_WIN32)
+    return (void *)wglGetCurrentContext();
+#elif defined(__APPLE__)
+    return (void *)CGLGetCurrentContext();
+#else
+    return (void *)glXGetCurrentContext();
+#endif
+}
+
+static gl_cache_context_t *gl_cache_find_context(void *context) {
+    for (uint32_t i = 0; i < gl_cache_context_count; i++) {
+        if (gl_cache_contexts[i].context == context) return &gl_cache_contexts[i];
+    }
+    return NULL;
+}
+
+static void gl_cache_remove_context(gl_cache_context_t *entry) {
+    *entry = gl_cache_contexts[--gl_cache_context_count];
+}
+
+static bool gl_cache_group_joined(uint32_t group) {
+    for (uint32_t i = 0; i < gl_cache_context_count; i++) {
+        if (gl_cache_contexts[i].group == group && gl_cache_contexts[i].joined) return true;
+    }
+    return false;
+}
+
+// Group of the current context; unknown contexts start their own group
+// (0 when there is no context to key on or the table is full: objects stay uncached)
+static uint32_t gl_cache_current_group(bool create) {
+    void *context = gl_cache_current_context();
+    if (!context) return 0;
+
+    gl_cache_context_t *entry = gl_cache_find_context(context);
+    if (entry) return entry->group;
+    if (!create || gl_cache_context_count == GL_CACHE_MAX_CONTEXTS) return 0;
+
+    entry = &gl_cache_contexts[gl_cache_context_count++];
+    entry->context = context;
+    entry->group = gl_cache_next_group++;
+    entry->joined = false;
+    return entry->group;
+}
+
+static gl_cache_entry_t *gl_cache_find_key(uint32_t group, bool texture, const char *key) {
+    for (uint32_t i = 0; i < gl_cache_entry_count; i++) {
+        gl_cache_entry_t *entry = &gl_cache_entries[i];
+        if (entry->group == group && entry->texture == texture && strcmp(entry->key, key) == 0) return entry;
+    }
+    return NULL;
+}
+
+static gl_cache_entry_t *gl_cache_find_name(uint32_t group, bool texture, GLuint name) {
+    for (uint32_t i = 0; i < gl_cache_entry_count; i++) {
+        gl_cache_entry_t *entry = &gl_cache_entries[i];
+        if (entry->group == group && entry->texture == texture && entry->name == name) return entry;
+    }
+    return NULL;
+}
+
+static void gl_cache_add(uint32_t group, bool texture, const char *key, GLuint name) {
+    if (!group || !name || gl_cache_entry_count == GL_CACHE_MAX_ENTRIES) return;
+
+    gl_cache_entry_t *entry = &gl_cache_entries[gl_cache_entry_count++];
+    entry->key = key;
+    entry->group = group;
+    entry->texture = texture;
+    entry->name = name;
+    entry->references = 1;
+}
+
+static void gl_cache_delete(const gl_cache_entry_t *entry) {
+    if (entry->texture) {
+        glDeleteTextures(1, &entry->name);
+    } else {
+        glDeleteProgram(entry->name);
+    }
+}
+
+// Drop every entry of a group (deleting the objects only if the group's context is current)
+static void gl_cache_drop_group(uint32_t group, bool delete_objects) {
+    uint32_t i = 0;
+    while (i < gl_cache_entry_count) {
+        if (gl_cache_entries[i].group == group) {
+            if (delete_objects) gl_cache_delete(&gl_cache_entries[i]);
+            gl_cache_entries[i] = gl_cache_entries[--gl_cache_entry_count];
+        } else {
+            i++;
+        }
+    }
+}
+
+void *gl_cache_share_context(void) {
+    pthread_mutex_lock(&gl_cache_lock);
+    void *context = NULL;
+    for (uint32_t i = 0; i < gl_cache_context_count && !context; i++) {
+        if (gl_cache_contexts[i].joined) context = gl_cache_contexts[i].context;
+    }
+    pthread_mutex_unlock(&gl_cache_lock);
+    return context;
+}
+
+bool gl_cache_join_context(void *context, void *share_context) {
+    if (!context) return false;
+
+    pthread_mutex_lock(&gl_cache_lock);
+    gl_cache_context_t *shared = share_context ? gl_cache_find_context(share_context) : NULL;
+    gl_cache_context_t *entry = gl_cache_find_context(context);
+    if (!entry && gl_cache_context_count < GL_CACHE_MAX_CONTEXTS) {
+        entry = &gl_cache_contexts[gl_cache_context_count++];
+        entry->context = context;
+        entry->group = shared ? shared->group : gl_cache_next_group++;
+    }
+    if (entry) entry->joined = true;
+    pthread_mutex_unlock(&gl_cache_lock);
+    return entry != NULL;
+}
+
+void gl_cache_leave_context(void *context) {
+    pthread_mutex_lock(&gl_cache_lock);
+    gl_cache_context_t *entry = gl_cache_find_context(context);
+    if (entry) {
+        uint32_t group = entry->group;
+        gl_cache_remove_context(entry);
+
+        bool last = true;
+        for (uint32_t i = 0; i < gl_cache_context_count; i++) {
+            if (gl_cache_contexts[i].group == group) last = false;
+        }
+        if (last) gl_cache_drop_group(group, context == gl_cache_current_context());
+    }
+    pthread_mutex_unlock(&gl_cache_lock);
+}
+
+GLuint gl_cache_acquire_program(const char *key, const char *vertex_source, const char *fragment_source) {
+    pthread_mutex_lock(&gl_cache_lock);
+    uint32_t group = gl_cache_current_group(true);
+    gl_cache_entry_t *entry = group ? gl_cache_find_key(group, false, key) : NULL;
+
+    GLuint program;
+    if (entry) {
+        entry->references++;
+        program = entry->name;
+    } else {
+        program = gl_ext_create_program(vertex_source, fragment_source);
+        gl_cache_add(group, false, key, program);
+    }
+    pthread_mutex_unlock(&gl_cache_lock);
+    return program;
+}
+
+// Pixels for a description: fixed data as given, built data once per process
+static const uint8_t *gl_cache_texture_pixels(const gl_cache_texture_desc_t *desc) {
+    if (desc->pixels || !desc->fill) return desc->pixels;
+
+    for (uint32_t i = 0; i < gl_cache_pixels_count; i++) {
+        const gl_cache_pixels_t *cached = &gl_cache_pixels[i];
+        if (strcmp(cached->key, desc->key) == 0 && cached->width == desc->width &&
+            cached->height == desc->height && cached->channels == desc->channels) {
+            return cached->pixels;
+        }
+    }
+    if (gl_cache_pixels_count == GL_CACHE_MAX_PIXELS) return NULL;
+
+    uint8_t *pixels = (uint8_t *)malloc((size_t)desc->width * desc->height * desc->channels);
+    if (!pixels) return NULL;
+    desc->fill(pixels, desc->width, desc->height, desc->channels);
+
+    gl_cache_pixels_t *cached = &gl_cache_pixels[gl_cache_pixels_count++];
+    cached->key = desc->key;
+    cached->width = desc->width;
+    cached->height = desc->height;
+    cached->channels = desc->channels;
+    cached->pixels = pixels;
+    return pixels;
+}
+
+GLuint gl_cache_acquire_texture(const gl_cache_texture_desc_t *desc) {
+    pthread_mutex_lock(&gl_cache_lock);
+    uint32_t group = gl_cache_current_group(true);
+    gl_cache_entry_t *entry = group ? gl_cache_find_key(group, true, desc->key) : NULL;
+    if (entry) {
+        entry->references++;
+        pthread_mutex_unlock(&gl_cache_lock);
+        return entry->name;
+    }
+
+    const uint8_t *pixels = gl_cache_texture_pixels(desc);
+    GLuint texture = 0;
+    if (pixels) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, desc->internal_format, desc->width, desc->height, 0,
+                     desc->format, GL_UNSIGNED_BYTE, pixels);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, desc->filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, desc->filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, desc->wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, desc->wrap);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        gl_cache_add(group, true, desc->key, texture);
+    }
+    pthread_mutex_unlock(&gl_cache_lock);
+    return texture;
+}
+
+static void gl_cache_release(bool texture, GLuint name) {
+    if (!name) return;
+
+    pthread_mutex_lock(&gl_cache_lock);
+    uint32_t group = gl_cache_current_group(false);
+    gl_cache_entry_t *entry = group ? gl_cache_find_name(group, texture, name) : NULL;
+    if (!entry) {
+        // Uncached object: owned by the caller alone
+        gl_cache_entry_t uncached = { NULL, 0, texture, name, 0 };
+        gl_cache_delete(&uncached);
+    } else if (--entry->references == 0 && !gl_cache_group_joined(group)) {
+        gl_cache_delete(entry);
+        *entry = gl_cache_entries[--gl_cache_entry_count];
+
+        // A discovered context with nothing cached is forgotten, so a later context
+        // that reuses its handle starts clean
+        bool empty = true;
+        for (uint32_t i = 0; i < gl_cache_entry_count; i++) {
+            if (gl_cache_entries[i].group == group) empty = false;
+        }
+        gl_cache_context_t *context = gl_cache_find_context(gl_cache_current_context());
+        if (empty && context) gl_cache_remove_context(context);
+    }
+    pthread_mutex_unlock(&gl_cache_lock);
+}
+
+void gl_cache_release_program(GLuint program) {
+    gl_cache_release(false, program);
+}
+
+void gl_cache_release_texture(GLuint texture) {
+    gl_cache_release(true, texture);
+}
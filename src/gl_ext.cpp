@@ -0,0 +1,104 @@
+#include "gl_ext.h"
+#include <stdio.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__APPLE__)
+#include <GL/glx.h>
+#endif
+
+#ifndef __APPLE__
+#define GL_EXT_DEFINE(type, name) type mf_##name = NULL;
+GL_EXT_FUNCTION_LIST(GL_EXT_DEFINE)
+#undef GL_EXT_DEFINE
+
+static void *gl_ext_get_proc(const char *name) {
+#if defined(_WIN32)
+    return (void *)wglGetProcAddress(name);
+#else
+    return (void *)glXGetProcAddressARB((const GLubyte *)name);
+#endif
+}
+#endif
+
+// Check the context version (entry points may resolve on contexts that cannot use them)
+static bool gl_ext_version_ok(void) {
+    const char *version = (const char *)glGetString(GL_VERSION);
+    int major = 0;
+    int minor = 0;
+
+    if (!version || sscanf(version, "%d.%d", &major, &minor) != 2) {
+        return false;
+    }
+    return major > 3 || (major == 3 && minor >= 3);
+}
+
+bool gl_ext_load(void) {
+    if (!gl_ext_version_ok()) {
+        return false;
+    }
+
+#ifndef __APPLE__
+    bool complete = true;
+
+#define GL_EXT_RESOLVE(type, name) \
+    mf_##name = (type)gl_ext_get_proc(#name); \
+    complete = complete && mf_##name != NULL;
+    GL_EXT_FUNCTION_LIST(GL_EXT_RESOLVE)
+#undef GL_EXT_RESOLVE
+
+    return complete;
+#else
+    return true;
+#endif
+}
+
+static GLuint gl_ext_compile_shader(GLenum type, const char *source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        fprintf(stderr, "Shader compile failed: %s\n", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+GLuint gl_ext_create_program(const char *vertex_source, const char *fragment_source) {
+    GLuint vertex_shader = gl_ext_compile_shader(GL_VERTEX_SHADER, vertex_source);
+    GLuint fragment_shader = gl_ext_compile_shader(GL_FRAGMENT_SHADER, fragment_source);
+
+    if (!vertex_shader || !fragment_shader) {
+        if (vertex_shader) glDeleteShader(vertex_shader);
+        if (fragment_shader) glDeleteShader(fragment_shader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex_shader);
+    glAttachShader(program, fragment_shader);
+    glLinkProgram(program);
+
+    // Shaders are owned by the program once linked
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), NULL, log);
+        fprintf(stderr, "Program link failed: %s\n", log);
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
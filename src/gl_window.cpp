@@ -0,0 +1,339 @@
+#include "gl_window.h"
+#include "gl_cache.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__APPLE__)
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <GL/glx.h>
+#endif
+
+// Grow the conversion buffer for a software present
+static bool gl_window_reserve(gl_window_t *window, uint32_t size) {
+    if (window->scratch_size >= size) return true;
+
+    uint8_t *scratch = (uint8_t *)realloc(window->scratch, size);
+    if (!scratch) return false;
+    window->scratch = scratch;
+    window->scratch_size = size;
+    return true;
+}
+
+// RGBA rows to the BGRX layout of 32-bit windows (X11 TrueColor, DIB sections)
+static void gl_window_swizzle(uint8_t *dst, const uint8_t *src, uint32_t pixels) {
+    for (uint32_t i = 0; i < pixels; i++) {
+        dst[i * 4 + 0] = src[i * 4 + 2];
+        dst[i * 4 + 1] = src[i * 4 + 1];
+        dst[i * 4 + 2] = src[i * 4 + 0];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+#if defined(_WIN32)
+
+#define GL_WINDOW_CLASS "MatrixFilterEditor"
+
+static LRESULT CALLBACK gl_window_proc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam) {
+    // Frames are driven by the editor's timer; painting is validated and left to it
+    if (message == WM_PAINT) {
+        ValidateRect(hwnd, NULL);
+        return 0;
+    }
+    return DefWindowProcA(hwnd, message, wparam, lparam);
+}
+
+bool gl_window_create(gl_window_t *window, void *parent, uint32_t width, uint32_t height) {
+    memset(window, 0, sizeof(gl_window_t));
+    if (!parent) return false;
+
+    WNDCLASSA window_class;
+    memset(&window_class, 0, sizeof(window_class));
+    window_class.style = CS_OWNDC;
+    window_class.lpfnWndProc = gl_window_proc;
+    window_class.hInstance = GetModuleHandleA(NULL);
+    window_class.lpszClassName = GL_WINDOW_CLASS;
+    RegisterClassA(&window_class);  // fails harmlessly once registered
+
+    HWND hwnd = CreateWindowExA(0, GL_WINDOW_CLASS, "", WS_CHILD | WS_VISIBLE, 0, 0, (int)width, (int)height,
+                                (HWND)parent, NULL, window_class.hInstance, NULL);
+    if (!hwnd) return false;
+    window->window = (uintptr_t)hwnd;
+    window->width = width;
+    window->height = height;
+
+    HDC device = GetDC(hwnd);
+    window->device = device;
+
+    PIXELFORMATDESCRIPTOR format;
+    memset(&format, 0, sizeof(format));
+    format.nSize = sizeof(format);
+    format.nVersion = 1;
+    format.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+    format.iPixelType = PFD_TYPE_RGBA;
+    format.cColorBits = 32;
+    int index = ChoosePixelFormat(device, &format);
+    if (!index || !SetPixelFormat(device, index, &format)) return true;
+
+    HGLRC context = wglCreateContext(device);
+    if (!context) return true;
+
+    // Sharing must be set up before the new context owns any objects
+    HGLRC share = (HGLRC)gl_cache_share_context();
+    if (share && !wglShareLists(share, context)) share = NULL;
+    window->context = (void *)context;
+    gl_cache_join_context(window->context, (void *)share);
+    return true;
+}
+
+bool gl_window_make_current(gl_window_t *window) {
+    return window->context && wglMakeCurrent((HDC)window->device, (HGLRC)window->context);
+}
+
+void gl_window_swap(gl_window_t *window) {
+    SwapBuffers((HDC)window->device);
+}
+
+void gl_window_present(gl_window_t *window, const soft_framebuffer_t *frame) {
+    if (!frame->pixels || frame->dirty_count == 0) return;
+
+    uint32_t rows = frame->dirty_last - frame->dirty_first;
+    if (!gl_window_reserve(window, rows * frame->width * 4)) return;
+    for (uint32_t y = 0; y < rows; y++) {
+        gl_window_swizzle(window->scratch + (size_t)y * frame->width * 4,
+                          frame->pixels + (size_t)(frame->dirty_first + y) * frame->stride, frame->width);
+    }
+
+    BITMAPINFO info;
+    memset(&info, 0, sizeof(info));
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = (LONG)frame->width;
+    info.bmiHeader.biHeight = -(LONG)rows;  // top row first
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+    SetDIBitsToDevice((HDC)window->device, 0, (int)frame->dirty_first, frame->width, rows, 0, 0, 0, rows,
+                      window->scratch, &info, DIB_RGB_COLORS);
+}
+
+void gl_window_resize(gl_window_t *window, uint32_t width, uint32_t height) {
+    if (!window->window) return;
+    SetWindowPos((HWND)window->window, NULL, 0, 0, (int)width, (int)height, SWP_NOMOVE | SWP_NOZORDER);
+    window->width = width;
+    window->height = height;
+}
+
+void gl_window_destroy(gl_window_t *window) {
+    if (window->context) {
+        gl_cache_leave_context(window->context);
+        wglMakeCurrent(NULL, NULL);
+        wglDeleteContext((HGLRC)window->context);
+    }
+    if (window->device) ReleaseDC((HWND)window->window, (HDC)window->device);
+    if (window->window) DestroyWindow((HWND)window->window);
+    free(window->scratch);
+    memset(window, 0, sizeof(gl_window_t));
+}
+
+#elif defined(__APPLE__)
+
+bool gl_window_create(gl_window_t *window, void *parent, uint32_t width, uint32_t height) {
+    memset(window, 0, sizeof(gl_window_t));
+    return false;
+}
+
+bool gl_window_make_current(gl_window_t *window) {
+    return false;
+}
+
+void gl_window_swap(gl_window_t *window) {
+}
+
+void gl_window_present(gl_window_t *window, const soft_framebuffer_t *frame) {
+}
+
+void gl_window_resize(gl_window_t *window, uint32_t width, uint32_t height) {
+}
+
+void gl_window_destroy(gl_window_t *window) {
+    free(window->scratch);
+    memset(window, 0, sizeof(gl_window_t));
+}
+
+#else
+
+// One display connection for every editor: GLX only shares between contexts
+// of the same connection on some drivers
+static pthread_mutex_t gl_window_lock = PTHREAD_MUTEX_INITIALIZER;
+static Display *gl_window_display = NULL;
+static uint32_t gl_window_display_users = 0;
+
+static Display *gl_window_open_display(void) {
+    pthread_mutex_lock(&gl_window_lock);
+    if (!gl_window_display) {
+        gl_window_display = XOpenDisplay(NULL);
+    }
+    if (gl_window_display) {
+        gl_window_display_users++;
+    }
+    Display *display = gl_window_display;
+    pthread_mutex_unlock(&gl_window_lock);
+    return display;
+}
+
+static void gl_window_close_display(void) {
+    pthread_mutex_lock(&gl_window_lock);
+    if (gl_window_display_users > 0 && --gl_window_display_users == 0) {
+        XCloseDisplay(gl_window_display);
+        gl_window_display = NULL;
+    }
+    pthread_mutex_unlock(&gl_window_lock);
+}
+
+// Double-buffered 8-bit RGBA window configuration (NULL when GLX has none)
+static GLXFBConfig gl_window_config(Display *display) {
+    static const int attributes[] = {
+        GLX_X_RENDERABLE, True,
+        GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT,
+        GLX_RENDER_TYPE, GLX_RGBA_BIT,
+        GLX_RED_SIZE, 8,
+        GLX_GREEN_SIZE, 8,
+        GLX_BLUE_SIZE, 8,
+        GLX_DOUBLEBUFFER, True,
+        None
+    };
+
+    int count = 0;
+    GLXFBConfig *configs = glXChooseFBConfig(display, DefaultScreen(display), attributes, &count);
+    if (!configs) return NULL;
+    GLXFBConfig config = count > 0 ? configs[0] : NULL;
+    XFree(configs);
+    return config;
+}
+
+bool gl_window_create(gl_window_t *window, void *parent, uint32_t width, uint32_t height) {
+    memset(window, 0, sizeof(gl_window_t));
+    if (!parent) return false;
+
+    Display *display = gl_window_open_display();
+    if (!display) return false;
+    window->display = display;
+    window->width = width;
+    window->height = height;
+
+    // The GL visual when there is one, the parent's otherwise (software frames)
+    GLXFBConfig config = gl_window_config(display);
+    XVisualInfo *visual = config ? glXGetVisualFromFBConfig(display, config) : NULL;
+
+    XSetWindowAttributes attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.event_mask = ExposureMask | StructureNotifyMask;
+    unsigned long mask = CWEventMask | CWBorderPixel;
+    if (visual) {
+        attributes.colormap = XCreateColormap(display, (Window)(uintptr_t)parent, visual->visual, AllocNone);
+        mask |= CWColormap;
+    }
+    Window handle = XCreateWindow(display, (Window)(uintptr_t)parent, 0, 0, width, height, 0,
+                                  visual ? visual->depth : CopyFromParent, InputOutput,
+                                  visual ? visual->visual : CopyFromParent, mask, &attributes);
+    if (visual) XFree(visual);
+    if (!handle) {
+        gl_window_close_display();
+        window->display = NULL;
+        return false;
+    }
+    window->window = (uintptr_t)handle;
+    XMapWindow(display, handle);
+
+    // Share with the longest-lived editor; a refused share starts a group of its own
+    if (config) {
+        GLXContext share = (GLXContext)gl_cache_share_context();
+        GLXContext context = glXCreateNewContext(display, config, GLX_RGBA_TYPE, share, True);
+        if (!context && share) {
+            share = NULL;
+            context = glXCreateNewContext(display, config, GLX_RGBA_TYPE, NULL, True);
+        }
+        if (context) {
+            window->context = (void *)context;
+            gl_cache_join_context(window->context, (void *)share);
+        }
+    }
+    XFlush(display);
+    return true;
+}
+
+bool gl_window_make_current(gl_window_t *window) {
+    return window->context &&
+           glXMakeCurrent((Display *)window->display, (Window)window->window, (GLXContext)window->context);
+}
+
+void gl_window_swap(gl_window_t *window) {
+    glXSwapBuffers((Display *)window->display, (Window)window->window);
+}
+
+void gl_window_present(gl_window_t *window, const soft_framebuffer_t *frame) {
+    if (!window->window || !frame->pixels || frame->dirty_count == 0) return;
+
+    Display *display = (Display *)window->display;
+    XWindowAttributes attributes;
+    if (!XGetWindowAttributes(display, (Window)window->window, &attributes) ||
+        (attributes.depth != 24 && attributes.depth != 32)) {
+        return;
+    }
+
+    uint32_t rows = frame->dirty_last - frame->dirty_first;
+    if (!gl_window_reserve(window, rows * frame->width * 4)) return;
+    for (uint32_t y = 0; y < rows; y++) {
+        gl_window_swizzle(window->scratch + (size_t)y * frame->width * 4,
+                          frame->pixels + (size_t)(frame->dirty_first + y) * frame->stride, frame->width);
+    }
+
+    // The image borrows the scratch rows; detach them before XDestroyImage frees it
+    XImage *image = XCreateImage(display, attributes.visual, (unsigned)attributes.depth, ZPixmap, 0,
+                                 (char *)window->scratch, frame->width, rows, 32, (int)(frame->width * 4));
+    if (!image) return;
+    GC gc = XCreateGC(display, (Window)window->window, 0, NULL);
+    XPutImage(display, (Window)window->window, gc, image, 0, 0, 0, (int)frame->dirty_first, frame->width, rows);
+    XFreeGC(display, gc);
+    image->data = NULL;
+    XDestroyImage(image);
+    XFlush(display);
+}
+
+void gl_window_resize(gl_window_t *window, uint32_t width, uint32_t height) {
+    if (!window->window) return;
+    XResizeWindow((Display *)window->display, (Window)window->window, width, height);
+    window->width = width;
+    window->height = height;
+}
+
+void gl_window_destroy(gl_window_t *window) {
+    Display *display = (Display *)window->display;
+    if (window->context) {
+        gl_cache_leave_context(window->context);
+        glXMakeCurrent(display, None, NULL);
+        glXDestroyContext(display, (GLXContext)window->context);
+    }
+    if (window->window) {
+        XDestroyWindow(display, (Window)window->window);
+    }
+    if (display) {
+        XFlush(display);
+        gl_window_close_display();
+    }
+    free(window->scratch);
+    memset(window, 0, sizeof(gl_window_t));
+}
+
+#endif
+
+bool gl_window_has_gl(const gl_window_t *window) {
+    return window->context != NULL;
+}
+
+void *gl_window_handle(const gl_window_t *window) {
+    return (void *)window->window;
+}
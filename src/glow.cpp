@@ -0,0 +1,247 @@
+#include "glow.h"
+#include "gl_cache.h"
+#include <string.h>
+
+// Fullscreen triangle generated from gl_VertexID (no vertex buffers)
+static const char *glow_vertex_shader =
+    "#version 330 core\n"
+    "out vec2 v_uv;\n"
+    "void main() {\n"
+    "    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+    "    v_uv = corner;\n"
+    "    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);\n"
+    "}\n";
+
+// 4x4 box downsample (four bilinear taps) keeping only the bright part of each pixel
+static const char *glow_bright_shader =
+    "#version 330 core\n"
+    "in vec2 v_uv;\n"
+    "uniform sampler2D u_scene;\n"
+    "out vec4 frag_color;\n"
+    "void main() {\n"
+    "    vec2 texel = 1.0 / vec2(textureSize(u_scene, 0));\n"
+    "    vec3 color = texture(u_scene, v_uv + texel * vec2(-1.0, -1.0)).rgb;\n"
+    "    color += texture(u_scene, v_uv + texel * vec2(1.0, -1.0)).rgb;\n"
+    "    color += texture(u_scene, v_uv + texel * vec2(-1.0, 1.0)).rgb;\n"
+    "    color += texture(u_scene, v_uv + texel * vec2(1.0, 1.0)).rgb;\n"
+    "    color *= 0.25;\n"
+    "    float peak = max(color.r, max(color.g, color.b));\n"
+    "    frag_color = vec4(color * (max(peak - 0.25, 0.0) / max(peak, 0.0001)), 1.0);\n"
+    "}\n";
+
+// 9-tap Gaussian along one axis, folded into 5 bilinear taps
+static const char *glow_blur_shader =
+    "#version 330 core\n"
+    "in vec2 v_uv;\n"
+    "uniform sampler2D u_source;\n"
+    "uniform vec2 u_direction;\n"
+    "out vec4 frag_color;\n"
+    "void main() {\n"
+    "    vec3 sum = texture(u_source, v_uv).rgb * 0.2270270270;\n"
+    "    sum += texture(u_source, v_uv + u_direction * 1.3846153846).rgb * 0.3162162162;\n"
+    "    sum += texture(u_source, v_uv - u_direction * 1.3846153846).rgb * 0.3162162162;\n"
+    "    sum += texture(u_source, v_uv + u_direction * 3.2307692308).rgb * 0.0702702703;\n"
+    "    sum += texture(u_source, v_uv - u_direction * 3.2307692308).rgb * 0.0702702703;\n"
+    "    frag_color = vec4(sum, 1.0);\n"
+    "}\n";
+
+// Upsampled glow, added on top of the copied scene
+static const char *glow_composite_shader =
+    "#version 330 core\n"
+    "in vec2 v_uv;\n"
+    "uniform sampler2D u_source;\n"
+    "uniform float u_intensity;\n"
+    "out vec4 frag_color;\n"
+    "void main() {\n"
+    "    frag_color = vec4(texture(u_source, v_uv).rgb * u_intensity, 1.0);\n"
+    "}\n";
+
+void glow_init(glow_pass_t *glow) {
+    memset(glow, 0, sizeof(glow_pass_t));
+    glow->intensity = 2.0f;
+}
+
+static void glow_release_targets(glow_pass_t *glow) {
+    if (glow->framebuffers[0]) {
+        glDeleteFramebuffers(3, glow->framebuffers);
+        glDeleteTextures(3, glow->textures);
+    }
+    memset(glow->framebuffers, 0, sizeof(glow->framebuffers));
+    memset(glow->textures, 0, sizeof(glow->textures));
+    glow->width = 0;
+    glow->height = 0;
+}
+
+void glow_destroy(glow_pass_t *glow) {
+    if (glow->gpu_ready) {
+        glow_release_targets(glow);
+        glDeleteVertexArrays(1, &glow->vao);
+        gl_cache_release_program(glow->bright_program);
+        gl_cache_release_program(glow->blur_program);
+        gl_cache_release_program(glow->composite_program);
+    }
+    glow_init(glow);
+}
+
+static GLuint glow_create_program(const char *key, const char *fragment_source) {
+    GLuint program = gl_cache_acquire_program(key, glow_vertex_shader, fragment_source);
+    if (!program) return 0;
+
+    // Every pass reads a single texture on unit 0
+    glUseProgram(program);
+    GLint location = glGetUniformLocation(program, "u_scene");
+    if (location >= 0) glUniform1i(location, 0);
+    location = glGetUniformLocation(program, "u_source");
+    if (location >= 0) glUniform1i(location, 0);
+    glUseProgram(0);
+
+    return program;
+}
+
+static bool glow_create_gpu(glow_pass_t *glow) {
+    if (!gl_ext_load()) return false;
+
+    glow->bright_program = glow_create_program("glow_bright", glow_bright_shader);
+    glow->blur_program = glow_create_program("glow_blur", glow_blur_shader);
+    glow->composite_program = glow_create_program("glow_composite", glow_composite_shader);
+    if (!glow->bright_program || !glow->blur_program || !glow->composite_program) {
+        gl_cache_release_program(glow->bright_program);
+        gl_cache_release_program(glow->blur_program);
+        gl_cache_release_program(glow->composite_program);
+        return false;
+    }
+
+    glow->u_blur_direction = glGetUniformLocation(glow->blur_program, "u_direction");
+    glow->u_composite_intensity = glGetUniformLocation(glow->composite_program, "u_intensity");
+
+    // Core profiles need a bound VAO even without attributes
+    glGenVertexArrays(1, &glow->vao);
+    return true;
+}
+
+static void glow_create_target(GLuint framebuffer, GLuint texture, uint32_t width, uint32_t height) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+}
+
+// (Re)allocate the offscreen targets for a new view size
+static bool glow_resize(glow_pass_t *glow, uint32_t width, uint32_t height) {
+    glow_release_targets(glow);
+
+    uint32_t glow_width = width / GLOW_DOWNSAMPLE > 0 ? width / GLOW_DOWNSAMPLE : 1;
+    uint32_t glow_height = height / GLOW_DOWNSAMPLE > 0 ? height / GLOW_DOWNSAMPLE : 1;
+
+    glGenFramebuffers(3, glow->framebuffers);
+    glGenTextures(3, glow->textures);
+
+    bool complete = true;
+    for (int i = 0; i < 3; i++) {
+        if (i == 0) {
+            glow_create_target(glow->framebuffers[i], glow->textures[i], width, height);
+        } else {
+            glow_create_target(glow->framebuffers[i], glow->textures[i], glow_width, glow_height);
+        }
+        complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (!complete) {
+        glow_release_targets(glow);
+        return false;
+    }
+
+    glow->width = width;
+    glow->height = height;
+    return true;
+}
+
+bool glow_begin(glow_pass_t *glow, uint32_t width, uint32_t height) {
+    if (glow->gpu_failed || width == 0 || height == 0) return false;
+
+    if (!glow->gpu_ready) {
+        glow->gpu_ready = glow_create_gpu(glow);
+        glow->gpu_failed = !glow->gpu_ready;
+        if (!glow->gpu_ready) return false;
+    }
+
+    // Remember where the composite goes (hosts may draw into their own framebuffer)
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &glow->target_framebuffer);
+    glGetIntegerv(GL_VIEWPORT, glow->target_viewport);
+
+    if (glow->width != width || glow->height != height) {
+        if (!glow_resize(glow, width, height)) {
+            glBindFramebuffer(GL_FRAMEBUFFER, glow->target_framebuffer);
+            glow->gpu_failed = true;
+            return false;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, glow->framebuffers[0]);
+    glViewport(0, 0, width, height);
+    glow->draw_calls = 0;
+    glow->vertices = 0;
+    return true;
+}
+
+// Draw a fullscreen pass from one texture into a target
+static void glow_draw_pass(glow_pass_t *glow, GLuint framebuffer, GLuint source, uint32_t width, uint32_t height) {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+    glBindTexture(GL_TEXTURE_2D, source);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glow->draw_calls++;
+    glow->vertices += 3;
+}
+
+void glow_end(glow_pass_t *glow) {
+    uint32_t glow_width = glow->width / GLOW_DOWNSAMPLE > 0 ? glow->width / GLOW_DOWNSAMPLE : 1;
+    uint32_t glow_height = glow->height / GLOW_DOWNSAMPLE > 0 ? glow->height / GLOW_DOWNSAMPLE : 1;
+
+    glDisable(GL_BLEND);
+    glBindVertexArray(glow->vao);
+    glActiveTexture(GL_TEXTURE0);
+
+    // Highlights at quarter resolution
+    glUseProgram(glow->bright_program);
+    glow_draw_pass(glow, glow->framebuffers[1], glow->textures[0], glow_width, glow_height);
+
+    // Separable blur: horizontal into the second target, vertical back into the first
+    glUseProgram(glow->blur_program);
+    glUniform2f(glow->u_blur_direction, 1.0f / glow_width, 0.0f);
+    glow_draw_pass(glow, glow->framebuffers[2], glow->textures[1], glow_width, glow_height);
+    glUniform2f(glow->u_blur_direction, 0.0f, 1.0f / glow_height);
+    glow_draw_pass(glow, glow->framebuffers[1], glow->textures[2], glow_width, glow_height);
+
+    // Copy the scene into the caller's framebuffer (a blit is far cheaper than a
+    // fullscreen pass on software rasterisers), then add the glow on top
+    const GLint *viewport = glow->target_viewport;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, glow->framebuffers[0]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, glow->target_framebuffer);
+    glBlitFramebuffer(0, 0, glow->width, glow->height,
+                      viewport[0], viewport[1], viewport[0] + viewport[2], viewport[1] + viewport[3],
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, glow->target_framebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glUseProgram(glow->composite_program);
+    glUniform1f(glow->u_composite_intensity, glow->intensity);
+    glBindTexture(GL_TEXTURE_2D, glow->textures[1]);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glow->draw_calls++;
+    glow->vertices += 3;
+
+    // Restore the state the rest of the editor expects
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
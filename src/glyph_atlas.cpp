@@ -0,0 +1,170 @@
+#include "glyph_atlas.h"
+#include <pthread.h>
+#include <string.h>
+
+// 5x7 glyphs, one byte per row (bit 4 = leftmost pixel)
+typedef struct {
+    char c;
+    uint8_t rows[7];
+} glyph_bitmap_t;
+
+static const glyph_bitmap_t glyph_font[] = {
+    { 'A', { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+    { 'B', { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+    { 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+    { 'D', { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C } },
+    { 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+    { 'F', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+    { 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+    { 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+    { 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+    { 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+    { 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+    { 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+    { 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+    { 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+    { 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+    { 'Q', { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } },
+    { 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+    { 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+    { 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+    { 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+    { 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+    { 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } },
+    { 'X', { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+    { 'Y', { 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04 } },
+    { 'Z', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+    { 'a', { 0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F } },
+    { 'b', { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E } },
+    { 'c', { 0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E } },
+    { 'd', { 0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F } },
+    { 'e', { 0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E } },
+    { 'f', { 0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08 } },
+    { 'g', { 0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x0E } },
+    { 'h', { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11 } },
+    { 'i', { 0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E } },
+    { 'j', { 0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0C } },
+    { 'k', { 0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12 } },
+    { 'l', { 0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { 'm', { 0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11 } },
+    { 'n', { 0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11 } },
+    { 'o', { 0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E } },
+    { 'p', { 0x00, 0x00, 0x1E, 0x11, 0x1E, 0x10, 0x10 } },
+    { 'q', { 0x00, 0x00, 0x0D, 0x13, 0x0F, 0x01, 0x01 } },
+    { 'r', { 0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10 } },
+    { 's', { 0x00, 0x00, 0x0E, 0x10, 0x0E, 0x01, 0x1E } },
+    { 't', { 0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06 } },
+    { 'u', { 0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D } },
+    { 'v', { 0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+    { 'w', { 0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A } },
+    { 'x', { 0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11 } },
+    { 'y', { 0x00, 0x00, 0x11, 0x11, 0x0F, 0x01, 0x0E } },
+    { 'z', { 0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F } },
+    { '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+    { '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+    { '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+    { '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+    { '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+    { '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+    { '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+    { '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+    { '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+    { '@', { 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E } },
+    { '#', { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A } },
+    { '$', { 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 } },
+    { '%', { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 } },
+    { '^', { 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 } },
+    { '&', { 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D } },
+    { '*', { 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 } },
+    { '(', { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 } },
+    { ')', { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 } },
+    { '_', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F } },
+    { '+', { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 } },
+    { '-', { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 } },
+    { '=', { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 } },
+    { '[', { 0x07, 0x04, 0x04, 0x04, 0x04, 0x04, 0x07 } },
+    { ']', { 0x1C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x1C } },
+    { '{', { 0x03, 0x04, 0x04, 0x08, 0x04, 0x04, 0x03 } },
+    { '}', { 0x18, 0x04, 0x04, 0x02, 0x04, 0x04, 0x18 } },
+    { '|', { 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+    { ';', { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 } },
+    { ':', { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 } },
+    { '\'', { 0x0C, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 } },
+    { ',', { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 } },
+    { '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C } },
+    { '<', { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 } },
+    { '>', { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 } },
+    { '?', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 } },
+    { '/', { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 } },
+};
+
+#define GLYPH_COUNT (sizeof(glyph_font) / sizeof(glyph_font[0]))
+
+// Cell 0 is the solid cell, glyphs follow in font order
+static uint8_t atlas_pixels[GLYPH_ATLAS_WIDTH * GLYPH_ATLAS_HEIGHT];
+static uint8_t atlas_cell_of_char[128];
+static pthread_once_t atlas_once = PTHREAD_ONCE_INIT;
+
+static void atlas_fill_cell(uint32_t cell, const uint8_t *rows) {
+    uint32_t cell_x = (cell % GLYPH_ATLAS_COLUMNS) * GLYPH_ATLAS_CELL;
+    uint32_t cell_y = (cell / GLYPH_ATLAS_COLUMNS) * GLYPH_ATLAS_CELL;
+
+    for (uint32_t y = 0; y < GLYPH_ATLAS_CELL; y++) {
+        uint8_t *row = &atlas_pixels[(cell_y + y) * GLYPH_ATLAS_WIDTH + cell_x];
+
+        if (!rows) {
+            memset(row, 255, GLYPH_ATLAS_CELL);
+            continue;
+        }
+
+        // Glyph sits at (1, 1) inside its cell, the rest is padding
+        for (uint32_t x = 0; x < GLYPH_ATLAS_CELL; x++) {
+            bool inside = x >= 1 && x <= 5 && y >= 1 && y <= 7;
+            row[x] = (inside && (rows[y - 1] & (0x10 >> (x - 1)))) ? 255 : 0;
+        }
+    }
+}
+
+static void atlas_build(void) {
+    memset(atlas_pixels, 0, sizeof(atlas_pixels));
+    memset(atlas_cell_of_char, 0, sizeof(atlas_cell_of_char));
+
+    atlas_fill_cell(0, NULL);
+
+    for (uint32_t i = 0; i < GLYPH_COUNT; i++) {
+        atlas_fill_cell(i + 1, glyph_font[i].rows);
+        atlas_cell_of_char[(uint8_t)glyph_font[i].c & 0x7F] = (uint8_t)(i + 1);
+    }
+}
+
+const uint8_t *glyph_atlas_pixels(void) {
+    pthread_once(&atlas_once, atlas_build);
+    return atlas_pixels;
+}
+
+static glyph_uv_t atlas_cell_uv(uint32_t cell, float inset) {
+    float cell_u = 1.0f / GLYPH_ATLAS_COLUMNS;
+    float cell_v = 1.0f / GLYPH_ATLAS_ROWS;
+    float u = (cell % GLYPH_ATLAS_COLUMNS) * cell_u;
+    float v = (cell / GLYPH_ATLAS_COLUMNS) * cell_v;
+
+    // Image row 0 is the top of a glyph, so the quad's bottom maps to the larger v
+    glyph_uv_t uv;
+    uv.u0 = u + inset * cell_u;
+    uv.u1 = u + (1.0f - inset) * cell_u;
+    uv.v0 = v + (1.0f - inset) * cell_v;
+    uv.v1 = v + inset * cell_v;
+    return uv;
+}
+
+glyph_uv_t glyph_atlas_lookup(char c) {
+    pthread_once(&atlas_once, atlas_build);
+    return atlas_cell_uv(atlas_cell_of_char[(uint8_t)c & 0x7F], 0.0f);
+}
+
+glyph_uv_t glyph_atlas_solid(void) {
+    // Sample well inside the cell so filtering never reaches the neighbours
+    return atlas_cell_uv(0, 0.25f);
+}
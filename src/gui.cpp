@@ -1,181 +1,202 @@
 #include "gui.h"
+#include "trace.h"
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
-
-// Matrix initialization
-void matrix_init(gui_context_t *gui) {
-    srand((unsigned int)time(NULL));
-    
-    for (int i = 0; i < MATRIX_WIDTH; ++i) {
-        gui->columns[i].x = i;
-        gui->columns[i].y = -rand() % MATRIX_HEIGHT;
-        gui->columns[i].speed = 0.5f + (rand() % 100) / 100.0f;
-        gui->columns[i].current_char = MATRIX_CHARS[rand() % (sizeof(MATRIX_CHARS) - 1)];
-        gui->columns[i].brightness = 0.0f;
-        gui->columns[i].target_brightness = 0.0f;
+#include <new>
+
+// Background behind everything (dark blue-black)
+static const float gui_clear_color[3] = { 0.0f, 0.1f, 0.2f };
+
+// Rendering helpers
+static void draw_audio_spectrum_visualization(gui_context_t *gui);
+static void draw_ui_overlay_elements(gui_context_t *gui);
+static void draw_corner_accent(quad_batch_t *batch, float x, float y, bool top_left);
+static void draw_level_meters(gui_context_t *gui);
+static void draw_loudness_meter(gui_context_t *gui);
+static void draw_cpu_load_overlay(gui_context_t *gui);
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define GUI_RESTRICT __restrict
+#else
+#define GUI_RESTRICT
+#endif
+
+// Carve the column arrays out of one zeroed block, each padded to whole 8-lane vectors
+static bool matrix_columns_alloc(matrix_columns_t *columns, uint32_t count) {
+    uint32_t stride = (count + 7) & ~7u;
+    uint32_t *block = (uint32_t *)calloc(8 * (size_t)stride, sizeof(uint32_t));
+    if (!block) return false;
+    
+    columns->y = (float *)(block + 0 * stride);
+    columns->speed = (float *)(block + 1 * stride);
+    columns->brightness = (float *)(block + 2 * stride);
+    columns->target_brightness = (float *)(block + 3 * stride);
+    columns->symbol = block + 4 * stride;
+    columns->rng = block + 5 * stride;
+    columns->level = (float *)(block + 6 * stride);
+    columns->random = block + 7 * stride;
+    columns->count = count;
+    columns->block = block;
+    return true;
+}
+
+// Start columns [first, count) above the grid at random heights, speeds and characters
+static void matrix_columns_scatter(matrix_columns_t *columns, uint32_t first, uint32_t grid_height) {
+    uint32_t count = columns->count - first;
+    uint32_t *random = columns->random + first;
+    
+    rng_next(columns->rng + first, random, count);
+    for (uint32_t i = 0; i < count; ++i) columns->y[first + i] = -(float)rng_below(random[i], grid_height);
+    rng_next(columns->rng + first, random, count);
+    for (uint32_t i = 0; i < count; ++i) columns->speed[first + i] = 0.5f + rng_unit(random[i]);
+    rng_next(columns->rng + first, random, count);
+    for (uint32_t i = 0; i < count; ++i) columns->symbol[first + i] = rng_below(random[i], MATRIX_CHAR_COUNT);
+}
+
+// Matrix initialization for the current grid (each instance seeds its own generators)
+bool matrix_init(gui_context_t *gui) {
+    matrix_columns_t *columns = &gui->columns;
+    if (!matrix_columns_alloc(columns, gui->grid_width)) {
+        return false;
     }
+    rng_seed(columns->rng, columns->count, cpu_meter_now_ns() ^ (uint64_t)(uintptr_t)gui);
+    matrix_columns_scatter(columns, 0, gui->grid_height);
     
     gui->time_accumulator = 0.0f;
+    return true;
 }
 
-// Update matrix animation
-void matrix_update(gui_context_t *gui, float delta_time) {
-    gui->time_accumulator += delta_time;
-    
-    for (int i = 0; i < MATRIX_WIDTH; ++i) {
-        matrix_column_t *col = &gui->columns[i];
-        
-        // Update position
-        col->y += col->speed * delta_time * 60.0f; // Normalize to 60fps
-        
-        // Reset when off screen
-        if (col->y >= MATRIX_HEIGHT) {
-            col->y = -1;
-            col->speed = 0.5f + (rand() % 100) / 100.0f;
-            col->current_char = MATRIX_CHARS[rand() % (sizeof(MATRIX_CHARS) - 1)];
-        }
-        
-        // Update brightness based on spectrum data
-        if (gui->spectrum.spectrum[0] > 0.01f) {
-            float normalized_freq = (float)i / (float)MATRIX_WIDTH;
-            uint32_t spectrum_index = (uint32_t)(normalized_freq * (MAX_FREQUENCY_BINS - 1));
-            col->target_brightness = gui->spectrum.spectrum[spectrum_index] * 2.0f;
-        } else {
-            col->target_brightness = 0.0f;
-        }
-        
-        // Smooth brightness transition
-        col->brightness += (col->target_brightness - col->brightness) * 0.1f;
-        
-        // Change character occasionally
-        if (col->brightness > 0.5f && ((rand() % 1000) == 0)) {
-            col->current_char = MATRIX_CHARS[rand() % (sizeof(MATRIX_CHARS) - 1)];
-        }
+// Follow a new grid size. Columns are reallocated only when the width changes and keep
+// their state where the old and new grids overlap; a shorter grid needs nothing, as
+// columns past the bottom restart on their next update.
+bool matrix_resize(gui_context_t *gui, uint32_t grid_width, uint32_t grid_height) {
+    matrix_columns_t *columns = &gui->columns;
+    if (columns->count == grid_width) return true;
+    
+    matrix_columns_t resized;
+    if (!matrix_columns_alloc(&resized, grid_width)) {
+        return false;
     }
+    
+    uint32_t kept = columns->count < grid_width ? columns->count : grid_width;
+    memcpy(resized.y, columns->y, kept * sizeof(float));
+    memcpy(resized.speed, columns->speed, kept * sizeof(float));
+    memcpy(resized.brightness, columns->brightness, kept * sizeof(float));
+    memcpy(resized.target_brightness, columns->target_brightness, kept * sizeof(float));
+    memcpy(resized.symbol, columns->symbol, kept * sizeof(uint32_t));
+    memcpy(resized.rng, columns->rng, kept * sizeof(uint32_t));
+    
+    rng_seed(resized.rng + kept, grid_width - kept, cpu_meter_now_ns() ^ (uint64_t)(uintptr_t)gui);
+    matrix_columns_scatter(&resized, kept, grid_height);
+    
+    free(columns->block);
+    *columns = resized;
+    return true;
 }
 
-// Spectrum analyzer initialization
-void spectrum_init(spectrum_analyzer_t *spectrum) {
-    memset(spectrum, 0, sizeof(spectrum_analyzer_t));
-    spectrum->sample_count = 0;
+void matrix_destroy(gui_context_t *gui) {
+    free(gui->columns.block);
+    memset(&gui->columns, 0, sizeof(matrix_columns_t));
 }
 
-// Simple FFT (Fast Fourier Transform) implementation
-static void fft_r2(float *real, float *imag, int n) {
-    if (n <= 1) return;
-    
-    // Bit reversal
-    for (int i = 1, j = 0; i < n; i++) {
-        int bit = n >> 1;
-        for (; j & bit; bit >>= 1) {
-            j ^= bit;
-        }
-        j ^= bit;
+// Per-frame constants of the column step
+typedef struct {
+    float grid_height;
+    float step;               // elapsed time in 60 Hz frames
+    float smoothing;          // brightness approach per step
+    uint32_t change_threshold;
+} matrix_step_t;
+
+// Step every column once. Selects are written as 0/1 multiplies so the loop
+// if-converts and vectorises.
+static void matrix_columns_step(const matrix_step_t *params, uint32_t count,
+                                const float *GUI_RESTRICT level, const uint32_t *GUI_RESTRICT random,
+                                float *GUI_RESTRICT y, float *GUI_RESTRICT speed,
+                                float *GUI_RESTRICT brightness, float *GUI_RESTRICT target_brightness,
+                                uint32_t *GUI_RESTRICT symbol) {
+    const float grid_height = params->grid_height;
+    const float step = params->step;
+    const float smoothing = params->smoothing;
+    const uint32_t change_threshold = params->change_threshold;
+    
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t r = random[i];
         
-        if (i < j) {
-            float temp = real[i];
-            real[i] = real[j];
-            real[j] = temp;
-            temp = imag[i];
-            imag[i] = imag[j];
-            imag[j] = temp;
-        }
-    }
-    
-    // FFT computation
-    for (int len = 2; len <= n; len <<= 1) {
-        float ang = -2.0f * M_PI / len;
-        float wlen_real = cosf(ang);
-        float wlen_imag = sinf(ang);
+        // Update position, resetting when off screen
+        float next_y = y[i] + speed[i] * step;
+        float new_speed = 0.5f + (float)(int32_t)(r & 0xffff) * (1.0f / 65536.0f);
+        float moving = (float)(next_y < grid_height);
+        y[i] = (next_y + 1.0f) * moving - 1.0f;
+        speed[i] = new_speed + (speed[i] - new_speed) * moving;
         
-        for (int i = 0; i < n; i += len) {
-            float w_real = 1.0f;
-            float w_imag = 0.0f;
-            
-            for (int j = 0; j < len / 2; j++) {
-                float u_real = real[i + j];
-                float u_imag = imag[i + j];
-                float v_real = real[i + j + len / 2] * w_real - imag[i + j + len / 2] * w_imag;
-                float v_imag = real[i + j + len / 2] * w_imag + imag[i + j + len / 2] * w_real;
-                
-                real[i + j] = u_real + v_real;
-                imag[i + j] = u_imag + v_imag;
-                real[i + j + len / 2] = u_real - v_real;
-                imag[i + j + len / 2] = u_imag - v_imag;
-                
-                float temp_real = w_real * wlen_real - w_imag * wlen_imag;
-                float temp_imag = w_real * wlen_imag + w_imag * wlen_real;
-                w_real = temp_real;
-                w_imag = temp_imag;
-            }
-        }
+        // Update brightness from the band level
+        float target = (float)(level[i] > 0.01f) * (level[i] * 2.0f);
+        float lit = brightness[i] + (target - brightness[i]) * smoothing;
+        target_brightness[i] = target;
+        brightness[i] = lit;
+        
+        // New character on reset, or occasionally while lit
+        bool change = (moving == 0.0f) | ((lit > 0.5f) & ((r >> 16) < change_threshold));
+        uint32_t next_symbol = rng_below(r * 0x9E3779B1u, MATRIX_CHAR_COUNT);
+        symbol[i] = change ? next_symbol : symbol[i];
     }
 }
 
-// Analyze audio spectrum
-void spectrum_analyze(spectrum_analyzer_t *spectrum, const float *audio_data, uint32_t frames) {
-    if (frames < MAX_FREQUENCY_BINS) return;
+// Update matrix animation: one branch-free pass over the column arrays
+void matrix_update(gui_context_t *gui, float delta_time) {
+    gui->time_accumulator += delta_time;
     
-    // Use Hamming window
-    static float window[MAX_FREQUENCY_BINS];
-    static bool window_initialized = false;
+    matrix_columns_t *columns = &gui->columns;
+    const uint32_t count = columns->count;
     
-    if (!window_initialized) {
-        for (int i = 0; i < MAX_FREQUENCY_BINS; i++) {
-            window[i] = 0.54f - 0.46f * cosf(2.0f * M_PI * i / (MAX_FREQUENCY_BINS - 1));
+    // Each column's log-spaced band level (bands are shared out when the grid is
+    // wider than the analysis, or briefly after a resize)
+    const uint32_t band_count = gui->spectrum->band_count;
+    if (band_count == count) {
+        memcpy(columns->level, gui->spectrum->bands, count * sizeof(float));
+    } else {
+        for (uint32_t i = 0; i < count; ++i) {
+            columns->level[i] = gui->spectrum->bands[(uint64_t)i * band_count / count];
         }
-        window_initialized = true;
     }
     
-    // Prepare data for FFT
-    float real[MAX_FREQUENCY_BINS];
-    float imag[MAX_FREQUENCY_BINS];
+    // One draw per column: low bits pick the new speed on reset, high bits decide
+    // the occasional character change, and a remix of all bits picks the character
+    rng_next(columns->rng, columns->random, count);
     
-    for (int i = 0; i < MAX_FREQUENCY_BINS; i++) {
-        real[i] = audio_data[i] * window[i];
-        imag[i] = 0.0f;
-    }
+    matrix_step_t params;
+    params.grid_height = (float)gui->grid_height;
+    params.step = delta_time * 60.0f; // Normalize to 60fps
+    params.smoothing = 1.0f - powf(0.9f, params.step); // 10% per 60 Hz frame, whatever the frame rate
+    params.change_threshold = (uint32_t)(fminf(params.step / 1000.0f, 1.0f) * 65535.0f); // 1 in 1000 per 60 Hz frame
     
-    // Perform FFT
-    fft_r2(real, imag, MAX_FREQUENCY_BINS);
-    
-    // Calculate magnitude spectrum
-    for (int i = 0; i < MAX_FREQUENCY_BINS / 2; i++) {
-        float magnitude = sqrtf(real[i] * real[i] + imag[i] * imag[i]) / MAX_FREQUENCY_BINS;
-        spectrum->spectrum[i] = magnitude;
-    }
-    
-    // Apply some smoothing
-    for (int i = 0; i < MAX_FREQUENCY_BINS / 2; i++) {
-        if (i > 0) {
-            spectrum->spectrum[i] = (spectrum->spectrum[i] * 0.7f) + (spectrum->spectrum[i-1] * 0.3f);
+    matrix_columns_step(&params, count, columns->level, columns->random, columns->y, columns->speed,
+                        columns->brightness, columns->target_brightness, columns->symbol);
+}
+
+// True when no column is lit or about to light up
+static bool matrix_is_settled(const gui_context_t *gui) {
+    const matrix_columns_t *columns = &gui->columns;
+    for (uint32_t i = 0; i < columns->count; ++i) {
+        if (columns->brightness[i] > MATRIX_SETTLED_BRIGHTNESS || columns->target_brightness[i] > 0.0f) {
+            return false;
         }
     }
+    return true;
 }
 
-// Update peak values for decay effect
-void spectrum_update_peaks(spectrum_analyzer_t *spectrum) {
-    for (int i = 0; i < MAX_FREQUENCY_BINS / 2; i++) {
-        if (spectrum->spectrum[i] > spectrum->peak_values[i]) {
-            spectrum->peak_values[i] = spectrum->spectrum[i];
-        } else {
-            spectrum->peak_values[i] *= 0.95f; // Decay
-        }
+// True when no band would light a column
+static bool spectrum_is_silent(const spectrum_analyzer_t *spectrum) {
+    for (uint32_t i = 0; i < spectrum->band_count; ++i) {
+        if (spectrum->bands[i] > 0.01f) return false;
     }
+    return true;
 }
 
-// Handle audio data from plugin
+// Handle audio data from plugin (audio thread: copy only, dropped if analysis falls behind)
 void gui_handle_audio_data(gui_context_t *gui, const float *audio_data, uint32_t frames) {
-    pthread_mutex_lock(&gui->mutex);
-    
-    if (frames >= MAX_FREQUENCY_BINS) {
-        spectrum_analyze(&gui->spectrum, audio_data, frames);
-        spectrum_update_peaks(&gui->spectrum);
-    }
-    
-    pthread_mutex_unlock(&gui->mutex);
+    TRACE_SCOPE("gui_handle_audio_data");
+    analysis_worker_push(&gui->analysis, audio_data, frames);
 }
 
 // OpenGL initialization
@@ -185,24 +206,19 @@ void opengl_init() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
-// Setup orthographic projection
+// Setup viewport (the quad batch maps matrix coordinates onto it)
 void opengl_setup_projection(uint32_t width, uint32_t height) {
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(0, MATRIX_WIDTH, 0, MATRIX_HEIGHT, -1, 1);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
     glViewport(0, 0, width, height);
 }
 
 // Clear screen with dark blue background
 void opengl_clear_screen() {
-    glClearColor(0.0f, 0.1f, 0.2f, 1.0f);  // Dark blue-black background
+    glClearColor(gui_clear_color[0], gui_clear_color[1], gui_clear_color[2], 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
 // Draw a single character in matrix style with enhanced blue theme
-void opengl_draw_character(float x, float y, float size, char c, float brightness) {
+void opengl_draw_character(quad_batch_t *batch, float x, float y, float size, char c, float brightness) {
     if (brightness <= 0.01f) return;
     
     // Enhanced blue matrix color with depth
@@ -214,79 +230,62 @@ void opengl_draw_character(float x, float y, float size, char c, float brightnes
     float g = 0.05f * intensity_modifier;
     float b = alpha * intensity_modifier;
     
-    // Draw main character
-    glColor4f(r, g, b, alpha);
-    glBegin(GL_QUADS);
-    glVertex2f(x, y);
-    glVertex2f(x + size, y);
-    glVertex2f(x + size, y + size);
-    glVertex2f(x, y + size);
-    glEnd();
-    
-    // Enhanced glow effect with multiple layers
-    if (brightness > 0.3f) {
-        // Inner glow - brighter blue
-        glColor4f(r * 0.3f, g * 0.3f, b * 0.7f, alpha * 0.4f);
-        for (int i = 1; i <= 1; i++) {
-            glBegin(GL_QUADS);
-            glVertex2f(x - i*0.08f, y - i*0.08f);
-            glVertex2f(x + size + i*0.08f, y - i*0.08f);
-            glVertex2f(x + size + i*0.08f, y + size + i*0.08f);
-            glVertex2f(x - i*0.08f, y + size + i*0.08f);
-            glEnd();
+    // Draw main character (glyph from the atlas); glow is added by the post-process pass
+    quad_batch_push_glyph(batch, x, y, size, size, c, r, g, b, alpha);
+}
+
+// Render the enhanced matrix visualization with blue theme UI elements
+void matrix_render(gui_context_t *gui) {
+    TRACE_SCOPE("matrix_render");
+    
+    const quality_settings_t *quality = quality_governor_settings(&gui->quality);
+    const bool software = gui->backend == GUI_BACKEND_SOFTWARE;
+    
+    // Render the frame offscreen so highlights can be bloomed in one pass (GL only)
+    bool glow = false;
+    if (!software) {
+        opengl_init();
+        opengl_setup_projection(gui->width, gui->height);
+        glow = quality->glow && glow_begin(&gui->glow, gui->width, gui->height);
+        
+        // Procedural gradient covers every pixel; flat clear on pre-3.3 contexts
+        if (!background_draw(&gui->background)) {
+            opengl_clear_screen();
         }
         
-        // Outer glow - pale blue
-        glColor4f(r * 0.6f, g * 0.6f, b * 1.0f, alpha * 0.15f);
-        for (int i = 2; i <= 3; i++) {
-            glBegin(GL_QUADS);
-            glVertex2f(x - i*0.12f, y - i*0.12f);
-            glVertex2f(x + size + i*0.12f, y - i*0.12f);
-            glVertex2f(x + size + i*0.12f, y + size + i*0.12f);
-            glVertex2f(x - i*0.12f, y + size + i*0.12f);
-            glEnd();
+        // Waterfall history: one new texture row per analysis snapshot
+        if (quality->waterfall) {
+            spectrogram_push(&gui->spectrogram, gui->spectrum);
+            spectrogram_draw(&gui->spectrogram);
+        } else {
+            gui->spectrogram.draw_calls = 0;
+            gui->spectrogram.vertices = 0;
         }
     }
     
-    // Add subtle depth shadow for high brightness characters
-    if (brightness > 0.7f) {
-        glColor4f(0.0f, 0.0f, 0.1f, alpha * 0.2f);
-        glBegin(GL_QUADS);
-        glVertex2f(x + size*0.05f, y + size*0.05f);
-        glVertex2f(x + size + size*0.05f, y + size*0.05f);
-        glVertex2f(x + size + size*0.05f, y + size + size*0.05f);
-        glVertex2f(x + size*0.05f, y + size + size*0.05f);
-        glEnd();
-    }
-}
-
-// Render the enhanced matrix visualization with blue theme UI elements
-void matrix_render(gui_context_t *gui) {
-    opengl_clear_screen();
+    quad_batch_t *batch = &gui->batch;
+    quad_batch_begin(batch);
     
     float cell_size = 1.0f;
     
-    // Draw a subtle gradient background for visual depth
-    draw_background_gradient(gui);
-    
     // Draw audio spectrum visualization at the bottom
     draw_audio_spectrum_visualization(gui);
     
-    for (int i = 0; i < MATRIX_WIDTH; ++i) {
-        matrix_column_t *col = &gui->columns[i];
-        
-        if (col->y >= 0 && col->y < MATRIX_HEIGHT) {
-            int y_pos = (int)col->y;
+    const matrix_columns_t *columns = &gui->columns;
+    const float grid_height = (float)gui->grid_height;
+    for (uint32_t i = 0; i < columns->count; ++i) {
+        if (columns->y[i] >= 0 && columns->y[i] < grid_height) {
+            int y_pos = (int)columns->y[i];
             
             // Enhanced trailing characters with better depth
-            for (int trail = 0; trail < 6; trail++) {
+            for (int trail = 0; trail < (int)quality->trail_count; trail++) {
                 float trail_y = y_pos - trail * 0.75f;
-                float trail_brightness = col->brightness * (1.0f - trail * 0.15f);
+                float trail_brightness = columns->brightness[i] * (1.0f - trail * 0.15f);
                 float trail_size = cell_size * (0.8f - trail * 0.05f);
                 
-                if (trail_y >= 0 && trail_y < MATRIX_HEIGHT && trail_size > 0.3f) {
-                    opengl_draw_character(col->x, trail_y, trail_size, 
-                                        col->current_char, trail_brightness);
+                if (trail_y >= 0 && trail_y < grid_height && trail_size > 0.3f) {
+                    opengl_draw_character(batch, (float)i, trail_y, trail_size,
+                                          MATRIX_CHARS[columns->symbol[i]], trail_brightness);
                 }
             }
         }
@@ -294,49 +293,42 @@ void matrix_render(gui_context_t *gui) {
     
     // Draw UI overlay elements (control indicators, status)
     draw_ui_overlay_elements(gui);
-}
-
-// Draw subtle background gradient for depth
-static void draw_background_gradient(gui_context_t *gui) {
-    // Create a subtle vertical gradient from dark blue to slightly lighter blue
-    const int gradient_steps = 8;
-    for (int i = 0; i < gradient_steps; i++) {
-        float gradient_factor = (float)i / (gradient_steps - 1);
-        float alpha = 0.1f + (gradient_factor * 0.1f);
-        
-        // Dark blue gradient colors
-        float r = 0.0f;
-        float g = 0.08f + (gradient_factor * 0.04f);
-        float b = 0.16f + (gradient_factor * 0.08f);
-        
-        glColor4f(r, g, b, alpha);
-        
-        float y_start = (float)i * MATRIX_HEIGHT / gradient_steps;
-        float y_end = (float)(i + 1) * MATRIX_HEIGHT / gradient_steps;
-        
-        glBegin(GL_QUADS);
-        glVertex2f(0.0f, y_start);
-        glVertex2f(MATRIX_WIDTH, y_start);
-        glVertex2f(MATRIX_WIDTH, y_end);
-        glVertex2f(0.0f, y_end);
-        glEnd();
+    
+    // Submit the whole frame: one draw call, or one pass over the changed pixel rows
+    gui->stats.quads = batch->count;
+    if (software) {
+        soft_framebuffer_render(&gui->framebuffer, batch->quads, batch->count, (float)gui->grid_width, grid_height,
+                                gui_clear_color[0], gui_clear_color[1], gui_clear_color[2]);
+        gui->stats.draw_calls = 0;
+        gui->stats.vertices = 0;
+        return;
+    }
+    quad_batch_flush(batch, (float)gui->grid_width, grid_height);
+    gui->stats.draw_calls = gui->background.draw_calls + gui->spectrogram.draw_calls + batch->draw_calls;
+    gui->stats.vertices = gui->background.vertices + gui->spectrogram.vertices + batch->vertices;
+    
+    if (glow) {
+        glow_end(&gui->glow);
+        gui->stats.draw_calls += gui->glow.draw_calls;
+        gui->stats.vertices += gui->glow.vertices;
     }
 }
 
 // Draw audio spectrum visualization at the bottom
 static void draw_audio_spectrum_visualization(gui_context_t *gui) {
     const float spectrum_height = 3.0f;
-    const float spectrum_y = MATRIX_HEIGHT - spectrum_height;
-    const int spectrum_bars = 32; // Fewer bars for cleaner look
+    const float spectrum_y = gui->grid_height - spectrum_height;
+    const int spectrum_bars = (int)quality_governor_settings(&gui->quality)->spectrum_bars;
+    const int spectrum_bins = 32; // Bins shown whatever the bar count
     
     for (int i = 0; i < spectrum_bars; i++) {
-        float bar_width = (float)MATRIX_WIDTH / spectrum_bars;
+        float bar_width = (float)gui->grid_width / spectrum_bars;
         float x_pos = i * bar_width;
         
-        // Get corresponding spectrum data
+        // Get corresponding spectrum data (strongest bin under the bar)
         float spectrum_value = 0.0f;
-        if (i < MAX_FREQUENCY_BINS / 2) {
-            spectrum_value = gui->spectrum.spectrum[i] * 2.0f; // Amplify for visibility
+        for (int k = i * spectrum_bins / spectrum_bars; k < (i + 1) * spectrum_bins / spectrum_bars; k++) {
+            spectrum_value = fmaxf(spectrum_value, gui->spectrum->spectrum[k] * 2.0f); // Amplify for visibility
         }
         
         // Create blue spectrum bar with gradient
@@ -344,160 +336,439 @@ static void draw_audio_spectrum_visualization(gui_context_t *gui) {
         float bar_height = intensity * spectrum_height;
         
         // Base bar color (darker blue)
-        glColor4f(0.0f, 0.1f, 0.3f, 0.6f);
-        glBegin(GL_QUADS);
-        glVertex2f(x_pos, spectrum_y);
-        glVertex2f(x_pos + bar_width * 0.9f, spectrum_y);
-        glVertex2f(x_pos + bar_width * 0.9f, spectrum_y + bar_height);
-        glVertex2f(x_pos, spectrum_y + bar_height);
-        glEnd();
+        quad_batch_push(&gui->batch, x_pos, spectrum_y, bar_width * 0.9f, bar_height,
+                        0.0f, 0.1f, 0.3f, 0.6f);
         
         // Highlight bar (brighter blue)
         if (intensity > 0.1f) {
-            glColor4f(0.2f, 0.4f, 0.8f, 0.8f);
-            glBegin(GL_QUADS);
-            glVertex2f(x_pos + bar_width * 0.1f, spectrum_y + bar_height * 0.3f);
-            glVertex2f(x_pos + bar_width * 0.8f, spectrum_y + bar_height * 0.3f);
-            glVertex2f(x_pos + bar_width * 0.8f, spectrum_y + bar_height);
-            glVertex2f(x_pos + bar_width * 0.1f, spectrum_y + bar_height);
-            glEnd();
+            quad_batch_push(&gui->batch, x_pos + bar_width * 0.1f, spectrum_y + bar_height * 0.3f,
+                            bar_width * 0.7f, bar_height * 0.7f,
+                            0.2f, 0.4f, 0.8f, 0.8f);
         }
     }
 }
 
 // Draw UI overlay elements (status, control indicators)
 static void draw_ui_overlay_elements(gui_context_t *gui) {
-    // Draw a subtle border around the matrix area
-    glColor4f(0.1f, 0.3f, 0.6f, 0.3f); // Medium blue border
-    glLineWidth(2.0f);
-    glBegin(GL_LINE_LOOP);
-    glVertex2f(0.5f, 0.5f);
-    glVertex2f(MATRIX_WIDTH - 0.5f, 0.5f);
-    glVertex2f(MATRIX_WIDTH - 0.5f, MATRIX_HEIGHT - 0.5f);
-    glVertex2f(0.5f, MATRIX_HEIGHT - 0.5f);
-    glEnd();
+    quad_batch_t *batch = &gui->batch;
+    
+    // Draw a subtle border around the matrix area (medium blue, four thin edges)
+    const float border = 0.1f;
+    const float left = 0.5f;
+    const float bottom = 0.5f;
+    const float right = gui->grid_width - 0.5f;
+    const float top = gui->grid_height - 0.5f;
+    quad_batch_push(batch, left, bottom, right - left, border, 0.1f, 0.3f, 0.6f, 0.3f);
+    quad_batch_push(batch, left, top - border, right - left, border, 0.1f, 0.3f, 0.6f, 0.3f);
+    quad_batch_push(batch, left, bottom + border, border, top - bottom - 2.0f * border, 0.1f, 0.3f, 0.6f, 0.3f);
+    quad_batch_push(batch, right - border, bottom + border, border, top - bottom - 2.0f * border, 0.1f, 0.3f, 0.6f, 0.3f);
     
     // Add corner accents for visual interest
-    draw_corner_accent(2.0f, 2.0f, true);  // Top-left
-    draw_corner_accent(MATRIX_WIDTH - 4.0f, 2.0f, false);  // Top-right
+    draw_corner_accent(batch, 2.0f, 2.0f, true);  // Top-left
+    draw_corner_accent(batch, gui->grid_width - 4.0f, 2.0f, false);  // Top-right
+    
+    // Draw output level meters and loudness beside them
+    draw_level_meters(gui);
+    draw_loudness_meter(gui);
     
-    // Draw audio activity indicator
-    draw_audio_activity_indicator(gui);
+    // Draw processor CPU load next to it
+    draw_cpu_load_overlay(gui);
 }
 
 // Draw corner accent elements
-static void draw_corner_accent(float x, float y, bool top_left) {
-    glColor4f(0.4f, 0.6f, 1.0f, 0.6f); // Bright blue accent
-    
+static void draw_corner_accent(quad_batch_t *batch, float x, float y, bool top_left) {
     const float accent_size = 1.5f;
     
-    glBegin(GL_QUADS);
-    if (top_left) {
-        glVertex2f(x, y);
-        glVertex2f(x + accent_size, y);
-        glVertex2f(x + accent_size, y + accent_size * 0.3f);
-        glVertex2f(x, y + accent_size * 0.3f);
+    // Bright blue accent (both corners currently share the same shape)
+    (void)top_left;
+    quad_batch_push(batch, x, y, accent_size, accent_size * 0.3f, 0.4f, 0.6f, 1.0f, 0.6f);
+}
+
+// Meter bar height (0-1) for a level over [GUI_METER_FLOOR_DB, 0] dB
+static float meter_height_db(float db) {
+    return fminf(fmaxf((db - GUI_METER_FLOOR_DB) / -GUI_METER_FLOOR_DB, 0.0f), 1.0f);
+}
+
+// Same for a linear level
+static float meter_height(float level) {
+    return meter_height_db(20.0f * log10f(fmaxf(level, 1.0e-6f)));
+}
+
+// Draw output meters (top-right corner): RMS bars with peak ticks for L/R and
+// a correlation strip beneath, from the processor's level meter
+static void draw_level_meters(gui_context_t *gui) {
+    if (!gui->level_meter) return;
+    
+    const level_meter_stats_t *levels = &gui->level_stats;
+    const float bar_width = 0.4f;
+    const float bar_spacing = 0.5f;
+    const float bar_height = 1.0f;
+    const float tick_height = 0.08f;
+    const float strip_height = 0.12f;
+    
+    float base_x = gui->grid_width - 3.0f;
+    float base_y = gui->grid_height - 2.0f;
+    float strip_y = base_y - 0.1f - strip_height;
+    
+    // Backplate (bars and correlation strip)
+    quad_batch_push(&gui->batch, base_x - 0.1f, strip_y - 0.1f, 2.0f * bar_spacing + 0.1f,
+                    base_y + bar_height - strip_y + 0.2f, 0.0f, 0.05f, 0.15f, 0.5f);
+    
+    for (int ch = 0; ch < LEVEL_METER_CHANNELS; ch++) {
+        float x = base_x + ch * bar_spacing;
+        float rms = meter_height(levels->rms[ch]) * bar_height;
+        float peak = meter_height(levels->peak[ch]) * bar_height;
+        
+        // Blue RMS fill, peak tick turning red at full scale
+        quad_batch_push(&gui->batch, x, base_y, bar_width, rms, 0.0f, 0.4f, 0.9f, 0.8f);
+        if (levels->peak[ch] >= 1.0f) {
+            quad_batch_push(&gui->batch, x, base_y + peak - tick_height, bar_width, tick_height, 1.0f, 0.2f, 0.1f, 1.0f);
+        } else {
+            quad_batch_push(&gui->batch, x, base_y + peak - tick_height, bar_width, tick_height, 0.6f, 0.8f, 1.0f, 0.9f);
+        }
+    }
+    
+    // Correlation: marker from -1 (left, amber) to +1 (right, blue)
+    float strip_width = 2.0f * bar_spacing - 0.1f;
+    float position = (levels->correlation + 1.0f) * 0.5f;
+    quad_batch_push(&gui->batch, base_x, strip_y, strip_width, strip_height, 0.1f, 0.2f, 0.4f, 0.5f);
+    quad_batch_push(&gui->batch, base_x + position * (strip_width - 0.1f), strip_y, 0.1f, strip_height,
+                    1.0f - position * 0.8f, 0.6f, 0.2f + position * 0.8f, 0.9f);
+}
+
+// Draw loudness right of the level meters: momentary fill, short-term tick and
+// integrated line, amber once the true peak has passed GUI_TRUE_PEAK_WARNING_DB
+static void draw_loudness_meter(gui_context_t *gui) {
+    if (!gui->loudness_meter) return;
+    
+    const loudness_values_t *loudness = &gui->loudness;
+    const float bar_width = 0.4f;
+    const float bar_height = 1.0f;
+    const float tick_height = 0.08f;
+    
+    // Next to the two level bars, on the same row
+    float x = gui->grid_width - 3.0f + 1.1f;
+    float base_y = gui->grid_height - 2.0f;
+    
+    // Backplate
+    quad_batch_push(&gui->batch, x - 0.1f, base_y - 0.1f, bar_width + 0.2f, bar_height + 0.2f,
+                    0.0f, 0.05f, 0.15f, 0.5f);
+    
+    float momentary = meter_height_db(loudness->momentary) * bar_height;
+    float short_term = meter_height_db(loudness->short_term) * bar_height;
+    float integrated = meter_height_db(loudness->integrated) * bar_height;
+    if (loudness->true_peak > GUI_TRUE_PEAK_WARNING_DB) {
+        quad_batch_push(&gui->batch, x, base_y, bar_width, momentary, 1.0f, 0.6f, 0.1f, 0.8f);
     } else {
-        glVertex2f(x, y);
-        glVertex2f(x + accent_size, y);
-        glVertex2f(x + accent_size, y + accent_size * 0.3f);
-        glVertex2f(x, y + accent_size * 0.3f);
+        quad_batch_push(&gui->batch, x, base_y, bar_width, momentary, 0.1f, 0.7f, 0.8f, 0.8f);
     }
-    glEnd();
+    quad_batch_push(&gui->batch, x, base_y + short_term - tick_height, bar_width, tick_height, 0.6f, 0.8f, 1.0f, 0.9f);
+    quad_batch_push(&gui->batch, x - 0.1f, base_y + integrated - 0.5f * tick_height, bar_width + 0.2f, tick_height * 0.5f,
+                    1.0f, 1.0f, 1.0f, 0.9f);
 }
 
-// Draw audio activity indicator
-static void draw_audio_activity_indicator(gui_context_t *gui) {
-    // Calculate average audio level
-    float avg_level = 0.0f;
-    for (int i = 0; i < 16 && i < MAX_FREQUENCY_BINS / 2; i++) {
-        avg_level += gui->spectrum.spectrum[i];
+// Draw processor CPU load (p50/p99/max of the block budget) left of the level meters
+static void draw_cpu_load_overlay(gui_context_t *gui) {
+    if (!gui->cpu_meter) return;
+    
+    const float values[3] = { gui->cpu_stats.p50, gui->cpu_stats.p99, gui->cpu_stats.max };
+    const float bar_width = 0.3f;
+    const float bar_spacing = 0.4f;
+    const float bar_height = 1.0f;
+    
+    // Same row as the level meters
+    float base_x = gui->grid_width - 3.0f - 0.5f - 3.0f * bar_spacing;
+    float base_y = gui->grid_height - 2.0f;
+    
+    // Backplate
+    quad_batch_push(&gui->batch, base_x - 0.1f, base_y - 0.1f, 3.0f * bar_spacing + 0.1f, bar_height + 0.2f,
+                    0.0f, 0.05f, 0.15f, 0.5f);
+    
+    for (int i = 0; i < 3; i++) {
+        float load = fminf(values[i], 1.0f);
+        float x = base_x + i * bar_spacing;
+        
+        // Blue while within budget, amber close to an xrun
+        if (values[i] > 0.8f) {
+            quad_batch_push(&gui->batch, x, base_y, bar_width, load * bar_height, 1.0f, 0.6f, 0.1f, 0.9f);
+        } else {
+            quad_batch_push(&gui->batch, x, base_y, bar_width, load * bar_height, 0.2f, 0.4f + i * 0.15f, 1.0f, 0.8f);
+        }
     }
-    avg_level /= 16.0f;
-    
-    // Activity indicator position (top-right corner)
-    float indicator_x = MATRIX_WIDTH - 3.0f;
-    float indicator_y = MATRIX_HEIGHT - 2.0f;
-    
-    // Base indicator color based on activity level
-    float activity_alpha = fminf(avg_level * 3.0f, 1.0f);
-    glColor4f(0.0f, 0.4f, 0.9f, activity_alpha);
-    
-    // Draw activity pulse
-    const float pulse_size = 1.0f;
-    glBegin(GL_QUADS);
-    glVertex2f(indicator_x, indicator_y);
-    glVertex2f(indicator_x + pulse_size, indicator_y);
-    glVertex2f(indicator_x + pulse_size, indicator_y + pulse_size);
-    glVertex2f(indicator_x, indicator_y + pulse_size);
-    glEnd();
-    
-    // Add glow for high activity
-    if (activity_alpha > 0.6f) {
-        glColor4f(0.3f, 0.6f, 1.0f, activity_alpha * 0.3f);
-        glBegin(GL_QUADS);
-        glVertex2f(indicator_x - 0.2f, indicator_y - 0.2f);
-        glVertex2f(indicator_x + pulse_size + 0.2f, indicator_y - 0.2f);
-        glVertex2f(indicator_x + pulse_size + 0.2f, indicator_y + pulse_size + 0.2f);
-        glVertex2f(indicator_x - 0.2f, indicator_y + pulse_size + 0.2f);
-        glEnd();
+}
+
+// Whole cells that fit a pixel extent, within the grid limits
+static uint32_t gui_grid_cells(uint32_t pixels, float cell, uint32_t min_cells, uint32_t max_cells) {
+    long cells = lroundf((float)pixels / cell);
+    if (cells < (long)min_cells) return min_cells;
+    if (cells > (long)max_cells) return max_cells;
+    return (uint32_t)cells;
+}
+
+// Derive the grid from the pixel size, scale factor and cell size; buffers are only
+// touched when the grid actually changes, never per frame
+static bool gui_layout(gui_context_t *gui) {
+    uint32_t grid_width = gui_grid_cells(gui->width, gui->cell_width * gui->scale_factor,
+                                         MATRIX_MIN_WIDTH, MATRIX_MAX_WIDTH);
+    uint32_t grid_height = gui_grid_cells(gui->height, gui->cell_height * gui->scale_factor,
+                                          MATRIX_MIN_HEIGHT, MATRIX_MAX_HEIGHT);
+    if (grid_width == gui->grid_width && grid_height == gui->grid_height) return true;
+    
+    if (!matrix_resize(gui, grid_width, grid_height)) {
+        return false;
     }
+    gui->grid_width = grid_width;
+    gui->grid_height = grid_height;
+    
+    // One band per column, up to what the analysis provides
+    analysis_worker_set_band_count(&gui->analysis, grid_width);
+    return true;
 }
 
 // GUI creation
 bool gui_create(gui_context_t *gui, const clap_plugin_t *plugin, uint32_t width, uint32_t height) {
-    memset(gui, 0, sizeof(gui_context_t));
+    // Value-initialize in place: the analysis worker holds atomics, so no memset
+    new (gui) gui_context_t();
     
     gui->width = width;
     gui->height = height;
     gui->plugin = plugin;
+    gui->scale_factor = 1.0f;
+    gui->cell_width = MATRIX_CELL_WIDTH;
+    gui->cell_height = MATRIX_CELL_HEIGHT;
+    gui->grid_width = gui_grid_cells(width, MATRIX_CELL_WIDTH, MATRIX_MIN_WIDTH, MATRIX_MAX_WIDTH);
+    gui->grid_height = gui_grid_cells(height, MATRIX_CELL_HEIGHT, MATRIX_MIN_HEIGHT, MATRIX_MAX_HEIGHT);
+    
+    // Per-frame quad stream (GL resources are created on the first render)
+    if (!quad_batch_init(&gui->batch, 1024)) {
+        return false;
+    }
+    
+    if (!matrix_init(gui)) {
+        quad_batch_destroy(&gui->batch);
+        return false;
+    }
     
-    if (pthread_mutex_init(&gui->mutex, NULL) != 0) {
+    if (!analysis_worker_start(&gui->analysis)) {
+        matrix_destroy(gui);
+        quad_batch_destroy(&gui->batch);
         return false;
     }
+    analysis_worker_set_band_count(&gui->analysis, gui->grid_width);
     
     // Initialize components
-    matrix_init(gui);
-    spectrum_init(&gui->spectrum);
+    glow_init(&gui->glow);
+    background_init(&gui->background, 0.0f);
+    spectrogram_init(&gui->spectrogram);
+    gui->spectrum = analysis_worker_latest(&gui->analysis);
+    frame_scheduler_init(&gui->scheduler, FRAME_SCHEDULER_DEFAULT_HZ);
+    quality_governor_init(&gui->quality, FRAME_SCHEDULER_DEFAULT_HZ);
+    cpu_meter_stats_init(&gui->cpu_stats);
+    level_meter_stats_init(&gui->level_stats);
     
     gui->running = true;
-    
-    printf("GUI created: %dx%d\n", width, height);
+    TRACE_INIT();
     return true;
 }
 
 // GUI destruction
 void gui_destroy(gui_context_t *gui) {
     gui->running = false;
-    pthread_mutex_destroy(&gui->mutex);
+    quad_batch_destroy(&gui->batch);
+    glow_destroy(&gui->glow);
+    background_destroy(&gui->background);
+    spectrogram_destroy(&gui->spectrogram);
+    soft_framebuffer_destroy(&gui->framebuffer);
+    analysis_worker_stop(&gui->analysis);
+    matrix_destroy(gui);
+    TRACE_SHUTDOWN();
 }
 
-// Update GUI with audio buffer
-void gui_update(gui_context_t *gui, const float *audio_buffer, uint32_t frames, double sample_rate) {
-    if (!gui->running) return;
+// Update GUI with audio buffer; returns true when a frame is due and should be rendered
+bool gui_update(gui_context_t *gui, const float *audio_buffer, uint32_t frames, double sample_rate) {
+    if (!gui->running) return false;
+    
+    TRACE_SCOPE("gui_update");
     
-    // Update matrix animation
-    matrix_update(gui, 1.0f / 60.0f); // Assume 60fps
+    if (sample_rate > 0.0) {
+        analysis_worker_set_sample_rate(&gui->analysis, sample_rate);
+    }
     
-    // Store audio data for processing
+    // Audio passed in directly takes the same path as audio from the processor
     if (audio_buffer && frames > 0) {
-        static float *audio_copy = NULL;
-        static uint32_t audio_copy_size = 0;
-        
-        if (audio_copy_size < frames) {
-            if (audio_copy) free(audio_copy);
-            audio_copy = (float *)malloc(frames * sizeof(float));
-            audio_copy_size = frames;
-        }
-        
-        if (audio_copy) {
-            memcpy(audio_copy, audio_buffer, frames * sizeof(float));
-            gui_handle_audio_data(gui, audio_copy, frames);
+        gui_handle_audio_data(gui, audio_buffer, frames);
+    }
+    
+    // Latest complete spectrum from the worker (held until the next frame)
+    gui->spectrum = analysis_worker_latest(&gui->analysis);
+    
+    // Sound while idling brings the display rate back without waiting for the idle frame
+    if (gui->scheduler.idle && !spectrum_is_silent(gui->spectrum)) {
+        frame_scheduler_set_idle(&gui->scheduler, false);
+    }
+    
+    float delta_time;
+    if (!frame_scheduler_begin(&gui->scheduler, cpu_meter_now_ns(), &delta_time)) {
+        return false;
+    }
+    
+    // Update matrix animation by the real elapsed time
+    gui->frame_step = delta_time;
+    matrix_update(gui, delta_time);
+    
+    // Pick up processor load since the last frame
+    if (gui->cpu_meter) {
+        cpu_meter_poll(gui->cpu_meter, &gui->cpu_stats);
+    }
+    if (gui->level_meter) {
+        level_meter_poll(gui->level_meter, &gui->level_stats);
+    }
+    if (gui->loudness_meter) {
+        loudness_meter_read(gui->loudness_meter, &gui->loudness);
+    }
+    
+    // Nothing moving on screen: the overlay only needs a few frames per second
+    frame_scheduler_set_idle(&gui->scheduler, matrix_is_settled(gui));
+    return true;
+}
+
+// Editor resized to width x height physical pixels; false keeps the previous grid
+bool gui_resize(gui_context_t *gui, uint32_t width, uint32_t height) {
+    if (gui->backend == GUI_BACKEND_SOFTWARE && !soft_framebuffer_resize(&gui->framebuffer, width, height)) {
+        return false;
+    }
+    gui->width = width;
+    gui->height = height;
+    return gui_layout(gui);
+}
+
+// Clamp a requested editor size to the supported range
+void gui_constrain_size(int32_t *width, int32_t *height) {
+    if (*width < GUI_MIN_WIDTH) *width = GUI_MIN_WIDTH;
+    if (*width > GUI_MAX_WIDTH) *width = GUI_MAX_WIDTH;
+    if (*height < GUI_MIN_HEIGHT) *height = GUI_MIN_HEIGHT;
+    if (*height > GUI_MAX_HEIGHT) *height = GUI_MAX_HEIGHT;
+}
+
+// Host content scale (physical pixels per logical pixel)
+bool gui_set_scale_factor(gui_context_t *gui, float scale_factor) {
+    gui->scale_factor = scale_factor > 0.25f ? scale_factor : 0.25f;
+    return gui_layout(gui);
+}
+
+// Character cell size in logical pixels (smaller cells give a denser grid)
+bool gui_set_cell_size(gui_context_t *gui, float cell_width, float cell_height) {
+    gui->cell_width = cell_width > 1.0f ? cell_width : 1.0f;
+    gui->cell_height = cell_height > 1.0f ? cell_height : 1.0f;
+    return gui_layout(gui);
+}
+
+// Hold a quality tier (0 = cheapest), or hand it back to the governor with a negative tier
+void gui_set_quality_tier(gui_context_t *gui, int32_t tier) {
+    quality_governor_pin(&gui->quality, tier);
+}
+
+// Spectrum FFT size (power of two, 256-16384) and segment overlap (percent, 50-75);
+// the worker switches before its next pass
+void gui_set_analysis(gui_context_t *gui, uint32_t fft_size, uint32_t overlap_percent) {
+    analysis_worker_configure(&gui->analysis, fft_size, overlap_percent);
+}
+
+// Log-spaced FFT bands or semitone-spaced constant-Q bands (ANALYSIS_MODE_*)
+void gui_set_spectrum_mode(gui_context_t *gui, uint32_t mode) {
+    analysis_worker_set_mode(&gui->analysis, mode);
+}
+
+// Switch between GL and the software pixel buffer (allocated at the editor size,
+// with the background computed once per size)
+bool gui_set_backend(gui_context_t *gui, uint32_t backend) {
+    if (backend == GUI_BACKEND_SOFTWARE) {
+        if (!soft_framebuffer_resize(&gui->framebuffer, gui->width, gui->height) ||
+            !soft_framebuffer_set_background(&gui->framebuffer, background_fill, &gui->background)) {
+            return false;
         }
+    } else {
+        soft_framebuffer_destroy(&gui->framebuffer);
     }
+    gui->backend = backend;
+    return true;
 }
 
-// Render GUI
+// Pixels of the last software frame (NULL on the GL backend); callers of
+// gui_render_overlay set their own layer as its background
+soft_framebuffer_t *gui_framebuffer(gui_context_t *gui) {
+    return gui->backend == GUI_BACKEND_SOFTWARE ? &gui->framebuffer : NULL;
+}
+
+// Editor shown or hidden by the host (hidden editors render nothing)
+void gui_set_visible(gui_context_t *gui, bool visible) {
+    frame_scheduler_set_visible(&gui->scheduler, visible);
+}
+
+// Cap the frame rate at the display refresh (Hz)
+void gui_set_refresh_rate(gui_context_t *gui, double refresh_hz) {
+    frame_scheduler_set_refresh_rate(&gui->scheduler, refresh_hz);
+    quality_governor_set_refresh_rate(&gui->quality, refresh_hz);
+}
+
+// Milliseconds until gui_update will next let a frame through (timer-driven editors)
+uint32_t gui_frame_wait_ms(const gui_context_t *gui) {
+    return frame_scheduler_wait_ms(&gui->scheduler, cpu_meter_now_ns());
+}
+
+// Attach the processor's CPU meter (NULL to detach)
+void gui_set_cpu_meter(gui_context_t *gui, cpu_meter_t *meter) {
+    gui->cpu_meter = meter;
+    cpu_meter_stats_init(&gui->cpu_stats);
+}
+
+// Attach the processor's output level meter (NULL to detach)
+void gui_set_level_meter(gui_context_t *gui, level_meter_t *meter) {
+    gui->level_meter = meter;
+    level_meter_stats_init(&gui->level_stats);
+}
+
+// Attach the processor's loudness meter (NULL to detach)
+void gui_set_loudness_meter(gui_context_t *gui, const loudness_meter_t *meter) {
+    gui->loudness_meter = meter;
+    if (meter) loudness_meter_read(meter, &gui->loudness);
+}
+
+// Render GUI (the quality tier follows once the frame is presented)
 void gui_render(gui_context_t *gui) {
+    uint64_t start = cpu_meter_now_ns();
     matrix_render(gui);
+    gui->stats.frame_ms = (float)((cpu_meter_now_ns() - start) * 1.0e-6);
+    gui->frame_start_ns = start;
+}
+
+// Frame on screen: call after the swap or software present (glFinish offscreen).
+// Submission alone hides the rasteriser, which on software GL is most of the
+// frame, so the governor is fed the time from gui_render to here
+void gui_frame_presented(gui_context_t *gui) {
+    if (!gui->frame_start_ns) return;
+    
+    gui->stats.present_ms = (float)((cpu_meter_now_ns() - gui->frame_start_ns) * 1.0e-6);
+    gui->frame_start_ns = 0;
+    quality_governor_record(&gui->quality, gui->stats.present_ms);
+}
+
+// Render only the overlay layer on top of a host-drawn background
+void gui_render_overlay(gui_context_t *gui) {
+    quad_batch_begin(&gui->batch);
+    draw_ui_overlay_elements(gui);
+    
+    // Software: the caller's layer is the framebuffer's background image
+    // (soft_framebuffer_set_background), so backdrop and overlay are one pass and
+    // only rows whose overlay changed are restored and redrawn
+    if (gui->backend == GUI_BACKEND_SOFTWARE) {
+        soft_framebuffer_render(&gui->framebuffer, gui->batch.quads, gui->batch.count,
+                                (float)gui->grid_width, (float)gui->grid_height,
+                                gui_clear_color[0], gui_clear_color[1], gui_clear_color[2]);
+        return;
+    }
+    
+    opengl_init();
+    opengl_setup_projection(gui->width, gui->height);
+    quad_batch_flush(&gui->batch, (float)gui->grid_width, (float)gui->grid_height);
 }
\ No newline at end of file
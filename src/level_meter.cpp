@@ -0,0 +1,184 @@
+#include "level_meter.h"
+#include "cpu_meter.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define LEVEL_METER_RESTRICT __restrict
+#else
+#define LEVEL_METER_RESTRICT
+#endif
+
+// Independent accumulators per lane so the reduction vectorises without reassociating
+#define LEVEL_METER_LANES 8
+
+// Reader attempts before giving up on a poll while the writer keeps publishing
+#define LEVEL_METER_READ_ATTEMPTS 4
+
+typedef struct {
+    float peak[LEVEL_METER_CHANNELS];
+    float square[LEVEL_METER_CHANNELS];
+    float product;
+} level_meter_block_t;
+
+static uint32_t float_to_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_to_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static uint64_t double_to_bits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double bits_to_double(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Peaks, sums of squares and the cross product of one block in a single pass
+static void level_meter_reduce(const float *LEVEL_METER_RESTRICT left, const float *LEVEL_METER_RESTRICT right,
+                               uint32_t frames, level_meter_block_t *result) {
+    float peak_left[LEVEL_METER_LANES] = {0};
+    float peak_right[LEVEL_METER_LANES] = {0};
+    float square_left[LEVEL_METER_LANES] = {0};
+    float square_right[LEVEL_METER_LANES] = {0};
+    float product[LEVEL_METER_LANES] = {0};
+
+    uint32_t whole = frames & ~(uint32_t)(LEVEL_METER_LANES - 1);
+    for (uint32_t i = 0; i < whole; i += LEVEL_METER_LANES) {
+        for (uint32_t l = 0; l < LEVEL_METER_LANES; l++) {
+            float a = left[i + l];
+            float b = right[i + l];
+            float magnitude_a = fabsf(a);
+            float magnitude_b = fabsf(b);
+            peak_left[l] = magnitude_a > peak_left[l] ? magnitude_a : peak_left[l];
+            peak_right[l] = magnitude_b > peak_right[l] ? magnitude_b : peak_right[l];
+            square_left[l] += a * a;
+            square_right[l] += b * b;
+            product[l] += a * b;
+        }
+    }
+    for (uint32_t i = whole; i < frames; i++) {
+        float a = left[i];
+        float b = right[i];
+        peak_left[0] = fmaxf(peak_left[0], fabsf(a));
+        peak_right[0] = fmaxf(peak_right[0], fabsf(b));
+        square_left[0] += a * a;
+        square_right[0] += b * b;
+        product[0] += a * b;
+    }
+
+    memset(result, 0, sizeof(level_meter_block_t));
+    for (uint32_t l = 0; l < LEVEL_METER_LANES; l++) {
+        result->peak[0] = fmaxf(result->peak[0], peak_left[l]);
+        result->peak[1] = fmaxf(result->peak[1], peak_right[l]);
+        result->square[0] += square_left[l];
+        result->square[1] += square_right[l];
+        result->product += product[l];
+    }
+}
+
+void level_meter_init(level_meter_t *meter) {
+    meter->sequence.store(0, std::memory_order_relaxed);
+    meter->frames.store(0, std::memory_order_relaxed);
+    for (int ch = 0; ch < LEVEL_METER_CHANNELS; ch++) {
+        meter->mean_square_bits[ch].store(0, std::memory_order_relaxed);
+        meter->peak_bits[ch].store(0, std::memory_order_relaxed);
+        meter->mean_square[ch] = 0.0;
+    }
+    meter->mean_product_bits.store(0, std::memory_order_relaxed);
+    meter->total_frames = 0;
+    meter->mean_product = 0.0;
+}
+
+void level_meter_record(level_meter_t *meter, const float *const *channels, uint32_t channel_count, uint32_t frames,
+                        double sample_rate) {
+    if (channel_count == 0 || frames == 0 || sample_rate <= 0.0) return;
+
+    level_meter_block_t block;
+    level_meter_reduce(channels[0], channels[channel_count > 1 ? 1 : 0], frames, &block);
+
+    // One-pole integration of the block means: the block's weight is what a
+    // per-sample filter with the same time constant would give it
+    double weight = 1.0 - exp(-(double)frames / (LEVEL_METER_INTEGRATION_S * sample_rate));
+    double scale = 1.0 / (double)frames;
+    meter->total_frames += frames;
+    meter->mean_product += weight * (block.product * scale - meter->mean_product);
+    for (int ch = 0; ch < LEVEL_METER_CHANNELS; ch++) {
+        meter->mean_square[ch] += weight * (block.square[ch] * scale - meter->mean_square[ch]);
+
+        // Single writer: plain load/store keeps this wait-free without read-modify-write
+        if (block.peak[ch] > bits_to_float(meter->peak_bits[ch].load(std::memory_order_relaxed))) {
+            meter->peak_bits[ch].store(float_to_bits(block.peak[ch]), std::memory_order_relaxed);
+        }
+    }
+
+    // Odd sequence while the values are being replaced
+    uint32_t sequence = meter->sequence.load(std::memory_order_relaxed);
+    meter->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    meter->frames.store(meter->total_frames, std::memory_order_relaxed);
+    for (int ch = 0; ch < LEVEL_METER_CHANNELS; ch++) {
+        meter->mean_square_bits[ch].store(double_to_bits(meter->mean_square[ch]), std::memory_order_relaxed);
+    }
+    meter->mean_product_bits.store(double_to_bits(meter->mean_product), std::memory_order_relaxed);
+    meter->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void level_meter_stats_init(level_meter_stats_t *stats) {
+    memset(stats, 0, sizeof(level_meter_stats_t));
+}
+
+// Consistent copy of the integrated values (false if the writer kept replacing them)
+static bool level_meter_read(level_meter_t *meter, uint64_t *frames, double square[LEVEL_METER_CHANNELS],
+                             double *product) {
+    for (int attempt = 0; attempt < LEVEL_METER_READ_ATTEMPTS; attempt++) {
+        uint32_t sequence = meter->sequence.load(std::memory_order_acquire);
+        if (sequence & 1) continue;
+
+        *frames = meter->frames.load(std::memory_order_relaxed);
+        for (int ch = 0; ch < LEVEL_METER_CHANNELS; ch++) {
+            square[ch] = bits_to_double(meter->mean_square_bits[ch].load(std::memory_order_relaxed));
+        }
+        *product = bits_to_double(meter->mean_product_bits.load(std::memory_order_relaxed));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (meter->sequence.load(std::memory_order_relaxed) == sequence) return true;
+    }
+    return false;
+}
+
+bool level_meter_poll(level_meter_t *meter, level_meter_stats_t *stats) {
+    // Held peaks fall by real time, whether or not audio arrived
+    uint64_t now = cpu_meter_now_ns();
+    float elapsed = stats->last_poll_ns ? (float)((now - stats->last_poll_ns) * 1.0e-9) : 0.0f;
+    float fall = powf(10.0f, -LEVEL_METER_PEAK_FALL_DB_PER_S * elapsed / 20.0f);
+    stats->last_poll_ns = now;
+    for (int ch = 0; ch < LEVEL_METER_CHANNELS; ch++) {
+        float peak = bits_to_float(meter->peak_bits[ch].exchange(0, std::memory_order_relaxed));
+        stats->peak[ch] = fmaxf(peak, stats->peak[ch] * fall);
+    }
+
+    uint64_t frames;
+    double square[LEVEL_METER_CHANNELS];
+    double product;
+    if (!level_meter_read(meter, &frames, square, &product) || frames == stats->last_frames) return false;
+
+    for (int ch = 0; ch < LEVEL_METER_CHANNELS; ch++) {
+        stats->rms[ch] = (float)sqrt(fmax(square[ch], 0.0));
+    }
+    double norm = sqrt(square[0] * square[1]);
+    stats->correlation = norm > 1.0e-12 ? (float)fmin(fmax(product / norm, -1.0), 1.0) : 0.0f;
+    stats->last_frames = frames;
+    return true;
+}
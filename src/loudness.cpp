@@ -0,0 +1,256 @@
+#include "loudness.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define LOUDNESS_RESTRICT __restrict
+#else
+#define LOUDNESS_RESTRICT
+#endif
+
+// Independent accumulators per lane so the reductions vectorise without reassociating
+#define LOUDNESS_LANES 8
+
+// K-weighting stages: RBJ parameters fitted to the BS.1770 coefficients at 48 kHz,
+// so the response carries over to other sample rates
+#define LOUDNESS_SHELF_FREQ 1500.512f
+#define LOUDNESS_SHELF_Q 0.7073157f
+#define LOUDNESS_SHELF_GAIN 3.999795f
+#define LOUDNESS_HIGHPASS_FREQ 37.90370f
+#define LOUDNESS_HIGHPASS_Q 0.4972788f
+
+static uint32_t float_to_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_to_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Mean-square energy to LUFS (channel weights are 1 for left and right)
+static float loudness_from_energy(double energy) {
+    if (energy <= 0.0) return LOUDNESS_FLOOR;
+    float lufs = (float)(-0.691 + 10.0 * log10(energy));
+    return lufs > LOUDNESS_FLOOR ? lufs : LOUDNESS_FLOOR;
+}
+
+// Histogram bin for a block loudness at or above the absolute gate
+static uint32_t loudness_bin(float lufs) {
+    int32_t bin = (int32_t)((lufs - LOUDNESS_ABSOLUTE_GATE) * 10.0f);
+    if (bin < 0) return 0;
+    if (bin >= LOUDNESS_HISTOGRAM_BINS) return LOUDNESS_HISTOGRAM_BINS - 1;
+    return (uint32_t)bin;
+}
+
+// Windowed-sinc interpolator (cutoff at the input Nyquist) split into phases,
+// each normalised to unity DC gain
+static void loudness_build_kernel(loudness_meter_t *meter) {
+    const uint32_t length = LOUDNESS_OVERSAMPLE * LOUDNESS_TRUE_PEAK_TAPS;
+    const float centre = 0.5f * (float)(length - 1);
+    for (uint32_t p = 0; p < LOUDNESS_OVERSAMPLE; p++) {
+        float sum = 0.0f;
+        for (uint32_t j = 0; j < LOUDNESS_TRUE_PEAK_TAPS; j++) {
+            uint32_t k = p + LOUDNESS_OVERSAMPLE * j;
+            float t = ((float)k - centre) / LOUDNESS_OVERSAMPLE;
+            float sinc = fabsf(t) < 1.0e-6f ? 1.0f : sinf((float)M_PI * t) / ((float)M_PI * t);
+            float window = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * ((float)k + 0.5f) / length);
+            meter->true_peak_kernel[p][j] = sinc * window;
+            sum += sinc * window;
+        }
+        for (uint32_t j = 0; j < LOUDNESS_TRUE_PEAK_TAPS; j++) {
+            meter->true_peak_kernel[p][j] /= sum;
+        }
+    }
+}
+
+void loudness_meter_init(loudness_meter_t *meter, float sample_rate, uint32_t channels) {
+    meter->channels = channels < 1 ? 1 : (channels > LOUDNESS_CHANNELS ? LOUDNESS_CHANNELS : channels);
+    meter->sample_rate = sample_rate;
+    meter->step_frames = (uint32_t)lroundf(sample_rate * 0.1f);
+    if (meter->step_frames == 0) meter->step_frames = 1;
+
+    filter_bank_init(&meter->shelf, FILTER_TYPE_HIGHSHELF, LOUDNESS_SHELF_FREQ, LOUDNESS_SHELF_Q,
+                     LOUDNESS_SHELF_GAIN, sample_rate, meter->channels, 1);
+    filter_bank_init(&meter->highpass, FILTER_TYPE_HIGHPASS, LOUDNESS_HIGHPASS_FREQ, LOUDNESS_HIGHPASS_Q,
+                     0.0f, sample_rate, meter->channels, 1);
+    loudness_build_kernel(meter);
+    loudness_meter_reset(meter);
+}
+
+void loudness_meter_reset(loudness_meter_t *meter) {
+    filter_bank_reset(&meter->shelf);
+    filter_bank_reset(&meter->highpass);
+
+    meter->step_position = 0;
+    meter->step_energy = 0.0;
+    memset(meter->steps, 0, sizeof(meter->steps));
+    meter->step_head = 0;
+    meter->step_count = 0;
+    memset(meter->histogram_count, 0, sizeof(meter->histogram_count));
+    memset(meter->histogram_energy, 0, sizeof(meter->histogram_energy));
+    memset(meter->true_peak_history, 0, sizeof(meter->true_peak_history));
+    meter->true_peak = 0.0f;
+
+    meter->momentary_bits.store(float_to_bits(LOUDNESS_FLOOR), std::memory_order_relaxed);
+    meter->short_term_bits.store(float_to_bits(LOUDNESS_FLOOR), std::memory_order_relaxed);
+    meter->integrated_bits.store(float_to_bits(LOUDNESS_FLOOR), std::memory_order_relaxed);
+    meter->true_peak_bits.store(float_to_bits(LOUDNESS_FLOOR), std::memory_order_relaxed);
+}
+
+// Sum of squares of one channel segment
+static double loudness_energy(const float *LOUDNESS_RESTRICT samples, uint32_t frames) {
+    float lanes[LOUDNESS_LANES] = {0};
+    uint32_t whole = frames & ~(uint32_t)(LOUDNESS_LANES - 1);
+    for (uint32_t i = 0; i < whole; i += LOUDNESS_LANES) {
+        for (uint32_t l = 0; l < LOUDNESS_LANES; l++) {
+            lanes[l] += samples[i + l] * samples[i + l];
+        }
+    }
+    for (uint32_t i = whole; i < frames; i++) {
+        lanes[0] += samples[i] * samples[i];
+    }
+
+    double sum = 0.0;
+    for (uint32_t l = 0; l < LOUDNESS_LANES; l++) {
+        sum += lanes[l];
+    }
+    return sum;
+}
+
+// Largest |sample| of the oversampled signal. history holds TAPS - 1 earlier
+// samples followed by the frames to interpolate.
+static float loudness_true_peak(const float *LOUDNESS_RESTRICT history,
+                                const float (*LOUDNESS_RESTRICT kernel)[LOUDNESS_TRUE_PEAK_TAPS], uint32_t frames) {
+    const size_t last = LOUDNESS_TRUE_PEAK_TAPS - 1;
+    float lanes[LOUDNESS_LANES] = {0};
+    uint32_t whole = frames & ~(uint32_t)(LOUDNESS_LANES - 1);
+
+    for (uint32_t p = 0; p < LOUDNESS_OVERSAMPLE; p++) {
+        const float *taps = kernel[p];
+        for (uint32_t i = 0; i < whole; i += LOUDNESS_LANES) {
+            for (uint32_t l = 0; l < LOUDNESS_LANES; l++) {
+                float value = 0.0f;
+                for (uint32_t j = 0; j < LOUDNESS_TRUE_PEAK_TAPS; j++) {
+                    value += taps[j] * history[last + i + l - j];
+                }
+                float magnitude = fabsf(value);
+                lanes[l] = magnitude > lanes[l] ? magnitude : lanes[l];
+            }
+        }
+        for (uint32_t i = whole; i < frames; i++) {
+            float value = 0.0f;
+            for (uint32_t j = 0; j < LOUDNESS_TRUE_PEAK_TAPS; j++) {
+                value += taps[j] * history[last + i - j];
+            }
+            lanes[0] = fmaxf(lanes[0], fabsf(value));
+        }
+    }
+
+    float peak = 0.0f;
+    for (uint32_t l = 0; l < LOUDNESS_LANES; l++) {
+        peak = fmaxf(peak, lanes[l]);
+    }
+    return peak;
+}
+
+// Close a 100 ms step: update the windows, gate the 400 ms block and publish
+static void loudness_complete_step(loudness_meter_t *meter) {
+    meter->steps[meter->step_head] = meter->step_energy;
+    meter->step_head = (meter->step_head + 1) % LOUDNESS_SHORT_TERM_STEPS;
+    if (meter->step_count < LOUDNESS_SHORT_TERM_STEPS) meter->step_count++;
+    meter->step_energy = 0.0;
+    meter->step_position = 0;
+
+    // Newest steps are just before the head
+    double momentary = 0.0;
+    double short_term = 0.0;
+    for (uint32_t s = 0; s < meter->step_count; s++) {
+        double energy = meter->steps[(meter->step_head + LOUDNESS_SHORT_TERM_STEPS - 1 - s) % LOUDNESS_SHORT_TERM_STEPS];
+        if (s < LOUDNESS_MOMENTARY_STEPS) momentary += energy;
+        short_term += energy;
+    }
+    uint32_t momentary_steps = meter->step_count < LOUDNESS_MOMENTARY_STEPS ? meter->step_count : LOUDNESS_MOMENTARY_STEPS;
+    momentary /= (double)momentary_steps * meter->step_frames;
+    short_term /= (double)meter->step_count * meter->step_frames;
+
+    float momentary_lufs = loudness_from_energy(momentary);
+    meter->momentary_bits.store(float_to_bits(momentary_lufs), std::memory_order_relaxed);
+    meter->short_term_bits.store(float_to_bits(loudness_from_energy(short_term)), std::memory_order_relaxed);
+
+    // Gating blocks are 400 ms long with 75% overlap: one per step once four exist
+    if (meter->step_count < LOUDNESS_MOMENTARY_STEPS || momentary_lufs < LOUDNESS_ABSOLUTE_GATE) return;
+    uint32_t bin = loudness_bin(momentary_lufs);
+    meter->histogram_count[bin]++;
+    meter->histogram_energy[bin] += momentary;
+
+    // Relative gate from the mean of all blocks above the absolute gate
+    uint64_t count = 0;
+    double energy = 0.0;
+    for (uint32_t b = 0; b < LOUDNESS_HISTOGRAM_BINS; b++) {
+        count += meter->histogram_count[b];
+        energy += meter->histogram_energy[b];
+    }
+    uint32_t first = loudness_bin(loudness_from_energy(energy / count) + LOUDNESS_RELATIVE_GATE);
+    count = 0;
+    energy = 0.0;
+    for (uint32_t b = first; b < LOUDNESS_HISTOGRAM_BINS; b++) {
+        count += meter->histogram_count[b];
+        energy += meter->histogram_energy[b];
+    }
+    if (count > 0) {
+        meter->integrated_bits.store(float_to_bits(loudness_from_energy(energy / count)), std::memory_order_relaxed);
+    }
+}
+
+void loudness_meter_process(loudness_meter_t *meter, const float *const *channels, uint32_t frames) {
+    const uint32_t history = LOUDNESS_TRUE_PEAK_TAPS - 1;
+
+    for (uint32_t offset = 0; offset < frames; offset += LOUDNESS_CHUNK) {
+        uint32_t count = frames - offset < LOUDNESS_CHUNK ? frames - offset : LOUDNESS_CHUNK;
+
+        const float *inputs[LOUDNESS_CHANNELS];
+        float *weighted[LOUDNESS_CHANNELS];
+        for (uint32_t ch = 0; ch < meter->channels; ch++) {
+            inputs[ch] = channels[ch] + offset;
+            weighted[ch] = meter->weighted[ch];
+        }
+
+        // K-weighting: both stages through the multichannel kernels, the second in place
+        filter_bank_process(&meter->shelf, inputs, weighted, count);
+        filter_bank_process(&meter->highpass, weighted, weighted, count);
+
+        // Energy, split where a 100 ms step ends
+        for (uint32_t i = 0; i < count;) {
+            uint32_t segment = meter->step_frames - meter->step_position;
+            if (segment > count - i) segment = count - i;
+            for (uint32_t ch = 0; ch < meter->channels; ch++) {
+                meter->step_energy += loudness_energy(weighted[ch] + i, segment);
+            }
+            meter->step_position += segment;
+            i += segment;
+            if (meter->step_position == meter->step_frames) loudness_complete_step(meter);
+        }
+
+        // True peak on the unweighted signal
+        for (uint32_t ch = 0; ch < meter->channels; ch++) {
+            float *line = meter->true_peak_history[ch];
+            memcpy(line + history, inputs[ch], count * sizeof(float));
+            meter->true_peak = fmaxf(meter->true_peak, loudness_true_peak(line, meter->true_peak_kernel, count));
+            memmove(line, line + count, history * sizeof(float));
+        }
+    }
+
+    float true_peak = meter->true_peak > 0.0f ? 20.0f * log10f(meter->true_peak) : LOUDNESS_FLOOR;
+    meter->true_peak_bits.store(float_to_bits(true_peak), std::memory_order_relaxed);
+}
+
+void loudness_meter_read(const loudness_meter_t *meter, loudness_values_t *values) {
+    values->momentary = bits_to_float(meter->momentary_bits.load(std::memory_order_relaxed));
+    values->short_term = bits_to_float(meter->short_term_bits.load(std::memory_order_relaxed));
+    values->integrated = bits_to_float(meter->integrated_bits.load(std::memory_order_relaxed));
+    values->true_peak = bits_to_float(meter->true_peak_bits.load(std::memory_order_relaxed));
+}
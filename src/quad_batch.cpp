@@ -0,0 +1,233 @@
+#include "quad_batch.h"
+#include "gl_cache.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Unit quad corners expanded per instance in the vertex shader
+static const char *quad_vertex_shader =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 a_corner;\n"
+    "layout(location = 1) in vec4 a_rect;\n"
+    "layout(location = 2) in vec4 a_color;\n"
+    "layout(location = 3) in vec4 a_uv;\n"
+    "uniform vec2 u_view;\n"
+    "out vec4 v_color;\n"
+    "out vec2 v_uv;\n"
+    "void main() {\n"
+    "    vec2 position = a_rect.xy + a_corner * a_rect.zw;\n"
+    "    gl_Position = vec4(position / u_view * 2.0 - 1.0, 0.0, 1.0);\n"
+    "    v_color = a_color;\n"
+    "    v_uv = mix(a_uv.xy, a_uv.zw, a_corner);\n"
+    "}\n";
+
+// Glyph coverage modulates alpha (the solid cell is fully covered)
+static const char *quad_fragment_shader =
+    "#version 330 core\n"
+    "in vec4 v_color;\n"
+    "in vec2 v_uv;\n"
+    "uniform sampler2D u_atlas;\n"
+    "out vec4 frag_color;\n"
+    "void main() {\n"
+    "    frag_color = vec4(v_color.rgb, v_color.a * texture(u_atlas, v_uv).r);\n"
+    "}\n";
+
+bool quad_batch_init(quad_batch_t *batch, uint32_t capacity) {
+    memset(batch, 0, sizeof(quad_batch_t));
+
+    batch->quads = (quad_instance_t *)malloc(capacity * sizeof(quad_instance_t));
+    if (!batch->quads) return false;
+
+    batch->capacity = capacity;
+    batch->solid_uv = glyph_atlas_solid();
+    return true;
+}
+
+void quad_batch_destroy(quad_batch_t *batch) {
+    if (batch->atlas_texture) {
+        gl_cache_release_texture(batch->atlas_texture);
+    }
+    if (batch->gpu_ready) {
+        glDeleteBuffers(1, &batch->instance_vbo);
+        glDeleteBuffers(1, &batch->corner_vbo);
+        glDeleteVertexArrays(1, &batch->vao);
+        gl_cache_release_program(batch->program);
+    }
+
+    free(batch->quads);
+    memset(batch, 0, sizeof(quad_batch_t));
+}
+
+void quad_batch_begin(quad_batch_t *batch) {
+    batch->count = 0;
+    batch->draw_calls = 0;
+    batch->vertices = 0;
+}
+
+static void quad_batch_append(quad_batch_t *batch, float x, float y, float width, float height,
+                              float r, float g, float b, float a, const glyph_uv_t *uv) {
+    if (batch->count == batch->capacity) {
+        uint32_t capacity = batch->capacity ? batch->capacity * 2 : 256;
+        quad_instance_t *quads = (quad_instance_t *)realloc(batch->quads, capacity * sizeof(quad_instance_t));
+        if (!quads) return;
+
+        batch->quads = quads;
+        batch->capacity = capacity;
+    }
+
+    quad_instance_t *quad = &batch->quads[batch->count++];
+    quad->x = x;
+    quad->y = y;
+    quad->width = width;
+    quad->height = height;
+    quad->r = r;
+    quad->g = g;
+    quad->b = b;
+    quad->a = a;
+    quad->uv = *uv;
+}
+
+void quad_batch_push(quad_batch_t *batch, float x, float y, float width, float height,
+                     float r, float g, float b, float a) {
+    quad_batch_append(batch, x, y, width, height, r, g, b, a, &batch->solid_uv);
+}
+
+void quad_batch_push_glyph(quad_batch_t *batch, float x, float y, float width, float height, char c,
+                           float r, float g, float b, float a) {
+    glyph_uv_t uv = glyph_atlas_lookup(c);
+    quad_batch_append(batch, x, y, width, height, r, g, b, a, &uv);
+}
+
+// Shared glyph atlas (single channel: R8 on core, alpha texture on legacy contexts)
+static GLuint quad_batch_create_atlas(bool core) {
+    gl_cache_texture_desc_t desc;
+    memset(&desc, 0, sizeof(desc));
+    desc.key = core ? "glyph_atlas_r8" : "glyph_atlas_alpha";
+    desc.width = GLYPH_ATLAS_WIDTH;
+    desc.height = GLYPH_ATLAS_HEIGHT;
+    desc.channels = 1;
+    desc.internal_format = core ? GL_R8 : GL_ALPHA;
+    desc.format = core ? GL_RED : GL_ALPHA;
+    desc.pixels = glyph_atlas_pixels();
+
+    // Nearest filtering keeps the pixel-font look at any scale
+    desc.filter = GL_NEAREST;
+    desc.wrap = GL_CLAMP_TO_EDGE;
+    return gl_cache_acquire_texture(&desc);
+}
+
+// Create program, VAO and buffers for the instanced path
+static bool quad_batch_create_gpu(quad_batch_t *batch) {
+    if (!gl_ext_load()) return false;
+
+    batch->program = gl_cache_acquire_program("quad_batch", quad_vertex_shader, quad_fragment_shader);
+    if (!batch->program) return false;
+
+    batch->u_view = glGetUniformLocation(batch->program, "u_view");
+    batch->u_atlas = glGetUniformLocation(batch->program, "u_atlas");
+    batch->atlas_texture = quad_batch_create_atlas(true);
+
+    static const float corners[8] = { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+
+    glGenVertexArrays(1, &batch->vao);
+    glBindVertexArray(batch->vao);
+
+    glGenBuffers(1, &batch->corner_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, batch->corner_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (const void *)0);
+
+    glGenBuffers(1, &batch->instance_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, batch->instance_vbo);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(quad_instance_t),
+                          (const void *)offsetof(quad_instance_t, x));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(quad_instance_t),
+                          (const void *)offsetof(quad_instance_t, r));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(quad_instance_t),
+                          (const void *)offsetof(quad_instance_t, uv));
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    batch->gpu_capacity = 0;
+    return true;
+}
+
+// Legacy contexts: one immediate-mode batch for the whole frame
+static void quad_batch_flush_legacy(quad_batch_t *batch, float view_width, float view_height) {
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, view_width, 0, view_height, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    if (!batch->atlas_texture) {
+        batch->atlas_texture = quad_batch_create_atlas(false);
+    }
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, batch->atlas_texture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+    glBegin(GL_QUADS);
+    for (uint32_t i = 0; i < batch->count; i++) {
+        const quad_instance_t *q = &batch->quads[i];
+        glColor4f(q->r, q->g, q->b, q->a);
+        glTexCoord2f(q->uv.u0, q->uv.v0);
+        glVertex2f(q->x, q->y);
+        glTexCoord2f(q->uv.u1, q->uv.v0);
+        glVertex2f(q->x + q->width, q->y);
+        glTexCoord2f(q->uv.u1, q->uv.v1);
+        glVertex2f(q->x + q->width, q->y + q->height);
+        glTexCoord2f(q->uv.u0, q->uv.v1);
+        glVertex2f(q->x, q->y + q->height);
+    }
+    glEnd();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+}
+
+void quad_batch_flush(quad_batch_t *batch, float view_width, float view_height) {
+    if (batch->count == 0) return;
+
+    if (!batch->gpu_ready && !batch->gpu_failed) {
+        batch->gpu_ready = quad_batch_create_gpu(batch);
+        batch->gpu_failed = !batch->gpu_ready;
+    }
+
+    // Either path is one draw of four corners per quad
+    batch->draw_calls++;
+    batch->vertices += 4 * batch->count;
+
+    if (!batch->gpu_ready) {
+        quad_batch_flush_legacy(batch, view_width, view_height);
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, batch->instance_vbo);
+
+    // Orphan the buffer each frame so the driver never stalls on the previous draw
+    if (batch->gpu_capacity < batch->capacity) {
+        batch->gpu_capacity = batch->capacity;
+    }
+    glBufferData(GL_ARRAY_BUFFER, batch->gpu_capacity * sizeof(quad_instance_t), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, batch->count * sizeof(quad_instance_t), batch->quads);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glUseProgram(batch->program);
+    glUniform2f(batch->u_view, view_width, view_height);
+    glUniform1i(batch->u_atlas, 0);
+    glBindTexture(GL_TEXTURE_2D, batch->atlas_texture);
+    glBindVertexArray(batch->vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)batch->count);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+}
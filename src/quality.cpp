@@ -0,0 +1,93 @@
+#include "quality.h"
+#include <string.h>
+
+// Cheapest first; the top tier is the full look
+static const quality_settings_t quality_tiers[QUALITY_TIER_COUNT] = {
+    { 1, false,  8, false },
+    { 3, false, 16, true },
+    { 6, false, 32, true },
+    { 6, true,  32, true },
+};
+
+// Weight of the newest frame in the moving average
+#define QUALITY_AVERAGE_WEIGHT 0.1f
+
+static float quality_budget_ms(double refresh_hz) {
+    if (refresh_hz < 1.0) refresh_hz = 1.0;
+    return (float)(1000.0 / refresh_hz) * QUALITY_BUDGET_FRACTION;
+}
+
+static void quality_governor_change(quality_governor_t *governor, uint32_t tier) {
+    governor->tier = tier;
+    governor->settle = QUALITY_SETTLE_FRAMES;
+    governor->average_ms = 0.0f;
+    governor->over_frames = 0;
+    governor->under_frames = 0;
+}
+
+void quality_governor_init(quality_governor_t *governor, double refresh_hz) {
+    memset(governor, 0, sizeof(quality_governor_t));
+    governor->budget_ms = quality_budget_ms(refresh_hz);
+    governor->up_frames = QUALITY_UP_FRAMES;
+    governor->frames_since_up = QUALITY_MAX_UP_FRAMES;
+    quality_governor_change(governor, QUALITY_DEFAULT_TIER);
+}
+
+void quality_governor_set_refresh_rate(quality_governor_t *governor, double refresh_hz) {
+    governor->budget_ms = quality_budget_ms(refresh_hz);
+}
+
+void quality_governor_pin(quality_governor_t *governor, int32_t tier) {
+    if (tier < 0) {
+        governor->pinned = false;
+        quality_governor_change(governor, governor->tier);
+        return;
+    }
+    governor->pinned = true;
+    governor->tier = (uint32_t)tier < QUALITY_TIER_COUNT ? (uint32_t)tier : QUALITY_TIER_COUNT - 1;
+}
+
+bool quality_governor_record(quality_governor_t *governor, float frame_ms) {
+    if (governor->pinned) return false;
+
+    if (governor->frames_since_up < QUALITY_MAX_UP_FRAMES) {
+        governor->frames_since_up++;
+    }
+
+    // Restart the average after a change so the new tier is judged on its own frames
+    if (governor->settle > 0) {
+        governor->settle--;
+        governor->average_ms = frame_ms;
+        return false;
+    }
+    governor->average_ms += (frame_ms - governor->average_ms) * QUALITY_AVERAGE_WEIGHT;
+
+    if (governor->average_ms > governor->budget_ms * QUALITY_DOWN_RATIO) {
+        governor->under_frames = 0;
+        if (++governor->over_frames >= QUALITY_DOWN_FRAMES && governor->tier > 0) {
+            // An upgrade that could not hold makes the next attempt wait twice as long
+            if (governor->frames_since_up < 2 * governor->up_frames) {
+                governor->up_frames *= 2;
+                if (governor->up_frames > QUALITY_MAX_UP_FRAMES) governor->up_frames = QUALITY_MAX_UP_FRAMES;
+            }
+            quality_governor_change(governor, governor->tier - 1);
+            return true;
+        }
+    } else if (governor->average_ms < governor->budget_ms * QUALITY_UP_RATIO) {
+        governor->over_frames = 0;
+        if (++governor->under_frames >= governor->up_frames && governor->tier < QUALITY_TIER_COUNT - 1) {
+            governor->frames_since_up = 0;
+            quality_governor_change(governor, governor->tier + 1);
+            return true;
+        }
+    } else {
+        governor->over_frames = 0;
+        governor->under_frames = 0;
+    }
+
+    return false;
+}
+
+const quality_settings_t *quality_governor_settings(const quality_governor_t *governor) {
+    return &quality_tiers[governor->tier];
+}
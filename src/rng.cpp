@@ -0,0 +1,31 @@
+#include "rng.h"
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define RNG_RESTRICT __restrict
+#else
+#define RNG_RESTRICT
+#endif
+
+void rng_seed(uint32_t *state, uint32_t count, uint64_t seed) {
+    for (uint32_t i = 0; i < count; i++) {
+        seed += 0x9E3779B97F4A7C15ull;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+
+        uint32_t lane = (uint32_t)(z ^ (z >> 32));
+        state[i] = lane ? lane : 0x6D2B79F5u;
+    }
+}
+
+void rng_next(uint32_t *RNG_RESTRICT state, uint32_t *RNG_RESTRICT out, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t x = state[i];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state[i] = x;
+        out[i] = x;
+    }
+}
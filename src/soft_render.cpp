@@ -0,0 +1,315 @@
+#include "soft_render.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define SOFT_RESTRICT __restrict
+#else
+#define SOFT_RESTRICT
+#endif
+
+#define SOFT_HASH_PRIME 0x100000001B3ull
+
+// Pixels whose centres fall inside a quad: columns [x0, x1), rows [y0, y1) from the top
+typedef struct {
+    int32_t x0, x1, y0, y1;
+} soft_span_t;
+
+// View to buffer mapping
+typedef struct {
+    float scale_x;
+    float scale_y;
+    float view_height;
+} soft_view_t;
+
+static uint32_t soft_channel(float value) {
+    if (value <= 0.0f) return 0;
+    if (value >= 1.0f) return 255;
+    return (uint32_t)(value * 255.0f + 0.5f);
+}
+
+static int32_t soft_clamp(int32_t value, int32_t limit) {
+    if (value < 0) return 0;
+    return value > limit ? limit : value;
+}
+
+static bool soft_quad_span(const soft_framebuffer_t *framebuffer, const soft_view_t *view,
+                           const quad_instance_t *quad, soft_span_t *span) {
+    // A pixel is covered when its centre is, as with GL rasterisation
+    float left = quad->x * view->scale_x;
+    float right = (quad->x + quad->width) * view->scale_x;
+    float top = (view->view_height - (quad->y + quad->height)) * view->scale_y;
+    float bottom = (view->view_height - quad->y) * view->scale_y;
+
+    span->x0 = soft_clamp((int32_t)ceilf(left - 0.5f), (int32_t)framebuffer->width);
+    span->x1 = soft_clamp((int32_t)ceilf(right - 0.5f), (int32_t)framebuffer->width);
+    span->y0 = soft_clamp((int32_t)ceilf(top - 0.5f), (int32_t)framebuffer->height);
+    span->y1 = soft_clamp((int32_t)ceilf(bottom - 0.5f), (int32_t)framebuffer->height);
+    return span->x0 < span->x1 && span->y0 < span->y1;
+}
+
+// Map the view [0, view_width] x [0, view_height] onto the whole buffer
+static bool soft_framebuffer_view(const soft_framebuffer_t *framebuffer, float view_width, float view_height,
+                                  soft_view_t *view) {
+    if (!framebuffer->pixels || view_width <= 0.0f || view_height <= 0.0f) return false;
+
+    view->scale_x = framebuffer->width / view_width;
+    view->scale_y = framebuffer->height / view_height;
+    view->view_height = view_height;
+    return true;
+}
+
+static uint64_t soft_hash(uint64_t hash, const void *data, size_t size) {
+    const uint32_t *words = (const uint32_t *)data;
+    for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+        hash = (hash ^ words[i]) * SOFT_HASH_PRIME;
+    }
+    return hash;
+}
+
+bool soft_framebuffer_init(soft_framebuffer_t *framebuffer, uint32_t width, uint32_t height) {
+    memset(framebuffer, 0, sizeof(soft_framebuffer_t));
+    return soft_framebuffer_resize(framebuffer, width, height);
+}
+
+bool soft_framebuffer_resize(soft_framebuffer_t *framebuffer, uint32_t width, uint32_t height) {
+    if (framebuffer->pixels && framebuffer->width == width && framebuffer->height == height) return true;
+    if (width == 0 || height == 0) return false;
+
+    uint8_t *pixels = (uint8_t *)malloc((size_t)width * height * 4);
+    uint64_t *hashes = (uint64_t *)calloc(2 * (size_t)height, sizeof(uint64_t));
+    uint8_t *row_dirty = (uint8_t *)calloc(height, 1);
+    uint16_t *texel_x = (uint16_t *)malloc(width * sizeof(uint16_t));
+    uint8_t *coverage = (uint8_t *)malloc(width);
+    if (!pixels || !hashes || !row_dirty || !texel_x || !coverage) {
+        free(pixels);
+        free(hashes);
+        free(row_dirty);
+        free(texel_x);
+        free(coverage);
+        return false;
+    }
+
+    // The background source survives the reallocation
+    soft_fill_t background_fill = framebuffer->background_fill;
+    const void *background_user = framebuffer->background_user;
+    soft_framebuffer_destroy(framebuffer);
+    framebuffer->pixels = pixels;
+    framebuffer->width = width;
+    framebuffer->height = height;
+    framebuffer->stride = width * 4;
+    framebuffer->row_dirty = row_dirty;
+    framebuffer->row_hash = hashes;
+    framebuffer->row_hash_previous = hashes + height;
+    framebuffer->texel_x = texel_x;
+    framebuffer->coverage = coverage;
+    framebuffer->invalid = true;
+    return soft_framebuffer_set_background(framebuffer, background_fill, background_user);
+}
+
+void soft_framebuffer_destroy(soft_framebuffer_t *framebuffer) {
+    free(framebuffer->pixels);
+    free(framebuffer->row_dirty);
+    free(framebuffer->row_hash < framebuffer->row_hash_previous ? framebuffer->row_hash : framebuffer->row_hash_previous);
+    free(framebuffer->texel_x);
+    free(framebuffer->coverage);
+    free(framebuffer->background);
+    memset(framebuffer, 0, sizeof(soft_framebuffer_t));
+}
+
+void soft_framebuffer_invalidate(soft_framebuffer_t *framebuffer) {
+    framebuffer->invalid = true;
+}
+
+bool soft_framebuffer_set_background(soft_framebuffer_t *framebuffer, soft_fill_t fill, const void *user) {
+    free(framebuffer->background);
+    framebuffer->background = NULL;
+    framebuffer->background_fill = fill;
+    framebuffer->background_user = user;
+    framebuffer->invalid = true;
+    if (!fill || !framebuffer->pixels) return true;
+
+    framebuffer->background = (uint8_t *)malloc((size_t)framebuffer->stride * framebuffer->height);
+    if (!framebuffer->background) return false;
+    fill(user, framebuffer->background, framebuffer->width, framebuffer->height, framebuffer->stride);
+    return true;
+}
+
+// Blend one colour at constant alpha over a span: d = (s * a + d * (255 - a)) / 255,
+// rounded; the result stays opaque
+static void soft_blend_solid(uint8_t *SOFT_RESTRICT dst, uint32_t count,
+                             uint32_t r, uint32_t g, uint32_t b, uint32_t alpha) {
+    const uint32_t inverse = 255 - alpha;
+    const uint32_t sr = r * alpha + 128;
+    const uint32_t sg = g * alpha + 128;
+    const uint32_t sb = b * alpha + 128;
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t tr = dst[4 * i + 0] * inverse + sr;
+        uint32_t tg = dst[4 * i + 1] * inverse + sg;
+        uint32_t tb = dst[4 * i + 2] * inverse + sb;
+        dst[4 * i + 0] = (uint8_t)((tr + (tr >> 8)) >> 8);
+        dst[4 * i + 1] = (uint8_t)((tg + (tg >> 8)) >> 8);
+        dst[4 * i + 2] = (uint8_t)((tb + (tb >> 8)) >> 8);
+        dst[4 * i + 3] = 255;
+    }
+}
+
+// Same blend with a per-pixel alpha (glyph coverage times the quad's alpha)
+static void soft_blend_coverage(uint8_t *SOFT_RESTRICT dst, const uint8_t *SOFT_RESTRICT alpha, uint32_t count,
+                                uint32_t r, uint32_t g, uint32_t b) {
+    for (size_t i = 0; i < count; i++) {
+        uint32_t a = alpha[i];
+        uint32_t inverse = 255 - a;
+        uint32_t tr = dst[4 * i + 0] * inverse + r * a + 128;
+        uint32_t tg = dst[4 * i + 1] * inverse + g * a + 128;
+        uint32_t tb = dst[4 * i + 2] * inverse + b * a + 128;
+        dst[4 * i + 0] = (uint8_t)((tr + (tr >> 8)) >> 8);
+        dst[4 * i + 1] = (uint8_t)((tg + (tg >> 8)) >> 8);
+        dst[4 * i + 2] = (uint8_t)((tb + (tb >> 8)) >> 8);
+        dst[4 * i + 3] = 255;
+    }
+}
+
+// Scale glyph coverage by the quad's alpha
+static void soft_scale_coverage(uint8_t *SOFT_RESTRICT coverage, const uint8_t *SOFT_RESTRICT atlas_row,
+                                const uint16_t *SOFT_RESTRICT texel_x, uint32_t count, uint32_t alpha) {
+    for (size_t i = 0; i < count; i++) {
+        uint32_t t = atlas_row[texel_x[i]] * alpha + 128;
+        coverage[i] = (uint8_t)((t + (t >> 8)) >> 8);
+    }
+}
+
+// Fill a row with the opaque background colour
+static void soft_clear_row(uint8_t *SOFT_RESTRICT dst, uint32_t count, const uint8_t clear[4]) {
+    uint32_t pixel;
+    memcpy(&pixel, clear, 4);
+    for (size_t i = 0; i < count; i++) {
+        memcpy(dst + 4 * i, &pixel, 4);
+    }
+}
+
+// Hash what each row will show, clear the rows that changed and record the dirty range
+static void soft_framebuffer_mark(soft_framebuffer_t *framebuffer, const soft_view_t *view,
+                                  const quad_instance_t *quads, uint32_t count,
+                                  float view_width, const uint8_t clear[4]) {
+    const uint32_t height = framebuffer->height;
+
+    uint64_t seed = 0xCBF29CE484222325ull;
+    seed = soft_hash(seed, clear, 4);
+    seed = soft_hash(seed, &view_width, sizeof(float));
+    seed = soft_hash(seed, &view->view_height, sizeof(float));
+    for (uint32_t y = 0; y < height; y++) {
+        framebuffer->row_hash[y] = seed;
+    }
+
+    // Quads in draw order, so reordering them also changes the hash
+    for (uint32_t q = 0; q < count; q++) {
+        soft_span_t span;
+        if (!soft_quad_span(framebuffer, view, &quads[q], &span)) continue;
+
+        uint64_t quad_hash = soft_hash(0xCBF29CE484222325ull, &quads[q], sizeof(quad_instance_t));
+        for (int32_t y = span.y0; y < span.y1; y++) {
+            framebuffer->row_hash[y] = (framebuffer->row_hash[y] ^ quad_hash) * SOFT_HASH_PRIME;
+        }
+    }
+
+    framebuffer->dirty_first = height;
+    framebuffer->dirty_last = 0;
+    framebuffer->dirty_count = 0;
+    for (uint32_t y = 0; y < height; y++) {
+        bool dirty = framebuffer->invalid || framebuffer->row_hash[y] != framebuffer->row_hash_previous[y];
+        framebuffer->row_dirty[y] = dirty;
+        if (!dirty) continue;
+
+        if (framebuffer->dirty_first > y) framebuffer->dirty_first = y;
+        framebuffer->dirty_last = y + 1;
+        framebuffer->dirty_count++;
+        uint8_t *row = framebuffer->pixels + (size_t)y * framebuffer->stride;
+        if (framebuffer->background) {
+            memcpy(row, framebuffer->background + (size_t)y * framebuffer->stride, framebuffer->stride);
+        } else {
+            soft_clear_row(row, framebuffer->width, clear);
+        }
+    }
+    if (framebuffer->dirty_count == 0) {
+        framebuffer->dirty_first = 0;
+    }
+
+    uint64_t *previous = framebuffer->row_hash_previous;
+    framebuffer->row_hash_previous = framebuffer->row_hash;
+    framebuffer->row_hash = previous;
+    framebuffer->invalid = false;
+}
+
+// Blend quads in order into the dirty rows
+static void soft_framebuffer_blend(soft_framebuffer_t *framebuffer, const soft_view_t *view,
+                                   const quad_instance_t *quads, uint32_t count) {
+    const uint8_t *atlas = glyph_atlas_pixels();
+    const glyph_uv_t solid = glyph_atlas_solid();
+
+    for (uint32_t q = 0; q < count; q++) {
+        const quad_instance_t *quad = &quads[q];
+        soft_span_t span;
+        if (!soft_quad_span(framebuffer, view, quad, &span)) continue;
+
+        // Only dirty rows are drawn
+        int32_t y0 = span.y0 > (int32_t)framebuffer->dirty_first ? span.y0 : (int32_t)framebuffer->dirty_first;
+        int32_t y1 = span.y1 < (int32_t)framebuffer->dirty_last ? span.y1 : (int32_t)framebuffer->dirty_last;
+        if (y0 >= y1) continue;
+
+        uint32_t alpha = soft_channel(quad->a);
+        if (alpha == 0) continue;
+
+        uint32_t r = soft_channel(quad->r);
+        uint32_t g = soft_channel(quad->g);
+        uint32_t b = soft_channel(quad->b);
+        uint32_t columns = (uint32_t)(span.x1 - span.x0);
+        uint8_t *origin = framebuffer->pixels + (size_t)span.x0 * 4;
+
+        bool textured = memcmp(&quad->uv, &solid, sizeof(glyph_uv_t)) != 0;
+        if (!textured) {
+            for (int32_t y = y0; y < y1; y++) {
+                if (!framebuffer->row_dirty[y]) continue;
+                soft_blend_solid(origin + (size_t)y * framebuffer->stride, columns, r, g, b, alpha);
+            }
+            continue;
+        }
+
+        // Nearest atlas texel under each pixel centre: columns once per quad, rows per row
+        float du = (quad->uv.u1 - quad->uv.u0) / (quad->width * view->scale_x);
+        for (uint32_t i = 0; i < columns; i++) {
+            float u = quad->uv.u0 + ((float)(span.x0 + (int32_t)i) + 0.5f - quad->x * view->scale_x) * du;
+            framebuffer->texel_x[i] = (uint16_t)soft_clamp((int32_t)floorf(u * GLYPH_ATLAS_WIDTH), GLYPH_ATLAS_WIDTH - 1);
+        }
+
+        float dv = (quad->uv.v1 - quad->uv.v0) / (quad->height * view->scale_y);
+        for (int32_t y = y0; y < y1; y++) {
+            if (!framebuffer->row_dirty[y]) continue;
+
+            float above_bottom = (view->view_height - quad->y) * view->scale_y - ((float)y + 0.5f);
+            float v = quad->uv.v0 + above_bottom * dv;
+            int32_t texel_y = soft_clamp((int32_t)floorf(v * GLYPH_ATLAS_HEIGHT), GLYPH_ATLAS_HEIGHT - 1);
+
+            soft_scale_coverage(framebuffer->coverage, atlas + texel_y * GLYPH_ATLAS_WIDTH,
+                                framebuffer->texel_x, columns, alpha);
+            soft_blend_coverage(origin + (size_t)y * framebuffer->stride, framebuffer->coverage, columns, r, g, b);
+        }
+    }
+}
+
+void soft_framebuffer_render(soft_framebuffer_t *framebuffer, const quad_instance_t *quads, uint32_t count,
+                             float view_width, float view_height,
+                             float clear_r, float clear_g, float clear_b) {
+    soft_view_t view;
+    if (!soft_framebuffer_view(framebuffer, view_width, view_height, &view)) return;
+
+    const uint8_t clear[4] = {
+        (uint8_t)soft_channel(clear_r), (uint8_t)soft_channel(clear_g), (uint8_t)soft_channel(clear_b), 255
+    };
+    soft_framebuffer_mark(framebuffer, &view, quads, count, view_width, clear);
+    if (framebuffer->dirty_count == 0) return;
+
+    soft_framebuffer_blend(framebuffer, &view, quads, count);
+}
@@ -0,0 +1,184 @@
+#include "spectrogram.h"
+#include "gl_cache.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define SPECTROGRAM_RESTRICT __restrict
+#else
+#define SPECTROGRAM_RESTRICT
+#endif
+
+// Fullscreen triangle generated from gl_VertexID (no vertex buffers)
+static const char *spectrogram_vertex_shader =
+    "#version 330 core\n"
+    "out vec2 v_uv;\n"
+    "void main() {\n"
+    "    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+    "    v_uv = corner;\n"
+    "    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);\n"
+    "}\n";
+
+// The ring wraps in t: u_offset is the top edge of the newest row, one texture
+// height below it the oldest. Older rows fade towards the bottom.
+static const char *spectrogram_fragment_shader =
+    "#version 330 core\n"
+    "in vec2 v_uv;\n"
+    "uniform sampler2D u_history;\n"
+    "uniform float u_offset;\n"
+    "uniform float u_intensity;\n"
+    "out vec4 frag_color;\n"
+    "void main() {\n"
+    "    float level = texture(u_history, vec2(v_uv.x, u_offset - (1.0 - v_uv.y))).r;\n"
+    "    float fade = mix(0.3, 1.0, v_uv.y);\n"
+    "    frag_color = vec4(0.0, 0.3 * level, level, level * fade * u_intensity);\n"
+    "}\n";
+
+void spectrogram_init(spectrogram_t *spectrogram) {
+    memset(spectrogram, 0, sizeof(spectrogram_t));
+    spectrogram->intensity = 0.35f;
+}
+
+void spectrogram_destroy(spectrogram_t *spectrogram) {
+    if (spectrogram->gpu_ready) {
+        glDeleteBuffers(2, spectrogram->pbo);
+        glDeleteVertexArrays(1, &spectrogram->vao);
+        if (spectrogram->texture) glDeleteTextures(1, &spectrogram->texture);
+        gl_cache_release_program(spectrogram->program);
+    }
+    spectrogram_init(spectrogram);
+}
+
+// Magnitudes to 8-bit levels over [SPECTROGRAM_FLOOR_DB, 0] dB
+static void spectrogram_quantise(uint8_t *SPECTROGRAM_RESTRICT row, const float *SPECTROGRAM_RESTRICT bands,
+                                 uint32_t count) {
+    const float scale = 255.0f / -SPECTROGRAM_FLOOR_DB;
+    for (uint32_t i = 0; i < count; i++) {
+        float db = 20.0f * log10f(fmaxf(bands[i], 1.0e-6f));
+        float level = (db - SPECTROGRAM_FLOOR_DB) * scale;
+        row[i] = (uint8_t)(fminf(fmaxf(level, 0.0f), 255.0f) + 0.5f);
+    }
+}
+
+bool spectrogram_push(spectrogram_t *spectrogram, const spectrum_analyzer_t *spectrum) {
+    // Snapshots are only republished when the worker analysed more audio
+    if (spectrogram->has_snapshot && spectrum->sample_count == spectrogram->last_sample_count) return false;
+    spectrogram->has_snapshot = true;
+    spectrogram->last_sample_count = spectrum->sample_count;
+
+    uint32_t width = spectrum->band_count < ANALYSIS_MAX_BANDS ? spectrum->band_count : ANALYSIS_MAX_BANDS;
+    if (width == 0) return false;
+    if (width != spectrogram->width) {
+        // Columns no longer line up with the old rows: start a fresh history
+        spectrogram->width = width;
+        spectrogram->texture_width = 0;
+        spectrogram->head = 0;
+    }
+
+    spectrogram_quantise(spectrogram->row, spectrum->bands, width);
+    spectrogram->row_pending = true;
+    return true;
+}
+
+static bool spectrogram_create_gpu(spectrogram_t *spectrogram) {
+    if (!gl_ext_load()) return false;
+
+    spectrogram->program = gl_cache_acquire_program("spectrogram", spectrogram_vertex_shader,
+                                                    spectrogram_fragment_shader);
+    if (!spectrogram->program) return false;
+
+    glUseProgram(spectrogram->program);
+    glUniform1i(glGetUniformLocation(spectrogram->program, "u_history"), 0);
+    glUseProgram(0);
+    spectrogram->u_offset = glGetUniformLocation(spectrogram->program, "u_offset");
+    spectrogram->u_intensity = glGetUniformLocation(spectrogram->program, "u_intensity");
+
+    // Core profiles need a bound VAO even without attributes
+    glGenVertexArrays(1, &spectrogram->vao);
+    glGenBuffers(2, spectrogram->pbo);
+    return true;
+}
+
+// (Re)allocate the ring for the current width, cleared to silence
+static bool spectrogram_allocate(spectrogram_t *spectrogram) {
+    uint8_t *silence = (uint8_t *)calloc((size_t)spectrogram->width * SPECTROGRAM_ROWS, 1);
+    if (!silence) return false;
+
+    if (!spectrogram->texture) glGenTextures(1, &spectrogram->texture);
+    glBindTexture(GL_TEXTURE_2D, spectrogram->texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, spectrogram->width, SPECTROGRAM_ROWS, 0,
+                 GL_RED, GL_UNSIGNED_BYTE, silence);
+
+    // One texel per band and per row; t wraps so the ring can start anywhere
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    free(silence);
+
+    // Staging buffers sized for one row
+    for (int i = 0; i < 2; i++) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, spectrogram->pbo[i]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, spectrogram->width, NULL, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    spectrogram->texture_width = spectrogram->width;
+    return true;
+}
+
+// Write the pending row at the head of the ring. The row goes through the pixel
+// buffer not used last frame, so the copy into the texture need not wait for it.
+static void spectrogram_upload(spectrogram_t *spectrogram) {
+    GLuint pbo = spectrogram->pbo[spectrogram->pbo_index];
+    spectrogram->pbo_index ^= 1;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, spectrogram->width, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, spectrogram->width, spectrogram->row);
+
+    glBindTexture(GL_TEXTURE_2D, spectrogram->texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, spectrogram->head, spectrogram->width, 1,
+                    GL_RED, GL_UNSIGNED_BYTE, (const void *)0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    spectrogram->head = (spectrogram->head + 1) % SPECTROGRAM_ROWS;
+    spectrogram->row_pending = false;
+}
+
+bool spectrogram_draw(spectrogram_t *spectrogram) {
+    spectrogram->draw_calls = 0;
+    spectrogram->vertices = 0;
+    if (spectrogram->gpu_failed || spectrogram->width == 0) return false;
+
+    if (!spectrogram->gpu_ready) {
+        spectrogram->gpu_ready = spectrogram_create_gpu(spectrogram);
+        spectrogram->gpu_failed = !spectrogram->gpu_ready;
+        if (!spectrogram->gpu_ready) return false;
+    }
+    if (spectrogram->texture_width != spectrogram->width && !spectrogram_allocate(spectrogram)) {
+        return false;
+    }
+    if (spectrogram->row_pending) {
+        spectrogram_upload(spectrogram);
+    }
+
+    glUseProgram(spectrogram->program);
+    glUniform1f(spectrogram->u_offset, (float)spectrogram->head / SPECTROGRAM_ROWS);
+    glUniform1f(spectrogram->u_intensity, spectrogram->intensity);
+    glBindTexture(GL_TEXTURE_2D, spectrogram->texture);
+    glBindVertexArray(spectrogram->vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+
+    spectrogram->draw_calls = 1;
+    spectrogram->vertices = 3;
+    return true;
+}
@@ -0,0 +1,259 @@
+#include "trace.h"
+#include "cpu_meter.h"
+#include <atomic>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <process.h>
+#include <windows.h>
+#define trace_getpid _getpid
+#else
+#include <unistd.h>
+#define trace_getpid getpid
+#endif
+
+// Flush interval of the background writer
+#define TRACE_FLUSH_INTERVAL_MS 20
+
+typedef struct {
+    const char *name;
+    uint64_t timestamp_ns;
+    char phase;  // 'B' or 'E'
+} trace_event_t;
+
+// Per-thread single-producer/single-consumer ring
+typedef struct trace_ring {
+    trace_event_t events[TRACE_RING_SIZE];
+    std::atomic<uint32_t> write_pos;
+    std::atomic<uint32_t> read_pos;
+    std::atomic<uint32_t> dropped;
+
+    uint32_t tid;
+    char thread_name[32];
+    std::atomic<bool> name_pending;
+    std::atomic<bool> spare;  // reserved for an audio thread that has not claimed it yet
+
+    struct trace_ring *next;
+} trace_ring_t;
+
+// Global state: the ring list only grows, rings live for the rest of the process
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static std::atomic<trace_ring_t *> trace_rings(NULL);
+static std::atomic<bool> trace_active(false);
+static uint32_t trace_next_tid = 1;
+static int trace_refcount = 0;
+
+static FILE *trace_file = NULL;
+static bool trace_first_event = true;
+static uint64_t trace_start_ns = 0;
+static pthread_t trace_thread;
+static std::atomic<bool> trace_thread_running(false);
+
+static thread_local trace_ring_t *thread_ring = NULL;
+static thread_local bool thread_realtime = false;
+
+static void trace_sleep_ms(uint32_t ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
+// Allocate a ring and add it to the list (caller holds trace_lock)
+static trace_ring_t *trace_add_ring(bool spare) {
+    trace_ring_t *ring = (trace_ring_t *)calloc(1, sizeof(trace_ring_t));
+    if (!ring) return NULL;
+
+    ring->tid = trace_next_tid++;
+    snprintf(ring->thread_name, sizeof(ring->thread_name), spare ? "audio %u" : "thread %u", ring->tid);
+    ring->name_pending.store(true, std::memory_order_relaxed);
+    ring->spare.store(spare, std::memory_order_relaxed);
+    ring->next = trace_rings.load(std::memory_order_relaxed);
+    trace_rings.store(ring, std::memory_order_release);
+    return ring;
+}
+
+// Get (or create) the calling thread's ring; real-time threads never allocate
+static trace_ring_t *trace_get_ring(void) {
+    if (thread_ring || thread_realtime) return thread_ring;
+
+    pthread_mutex_lock(&trace_lock);
+    thread_ring = trace_add_ring(false);
+    pthread_mutex_unlock(&trace_lock);
+    return thread_ring;
+}
+
+static void trace_push(const char *name, char phase) {
+    if (!trace_active.load(std::memory_order_relaxed)) return;
+
+    trace_ring_t *ring = trace_get_ring();
+    if (!ring) return;
+
+    uint32_t write_pos = ring->write_pos.load(std::memory_order_relaxed);
+    uint32_t read_pos = ring->read_pos.load(std::memory_order_acquire);
+
+    // Drop rather than wait when the writer thread falls behind
+    if (write_pos - read_pos >= TRACE_RING_SIZE) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    trace_event_t *event = &ring->events[write_pos & (TRACE_RING_SIZE - 1)];
+    event->name = name;
+    event->timestamp_ns = cpu_meter_now_ns();
+    event->phase = phase;
+
+    ring->write_pos.store(write_pos + 1, std::memory_order_release);
+}
+
+void trace_begin(const char *name) {
+    trace_push(name, 'B');
+}
+
+void trace_end(const char *name) {
+    trace_push(name, 'E');
+}
+
+void trace_set_thread_name(const char *name) {
+    if (!trace_active.load(std::memory_order_relaxed)) return;
+
+    trace_ring_t *ring = trace_get_ring();
+    if (!ring) return;
+
+    // Published to the writer through name_pending
+    snprintf(ring->thread_name, sizeof(ring->thread_name), "%s", name);
+    ring->name_pending.store(true, std::memory_order_release);
+}
+
+void trace_reserve_audio_ring(void) {
+    if (!trace_active.load(std::memory_order_relaxed)) return;
+
+    // Keep one spare: an audio thread that already claimed a ring needs no more
+    pthread_mutex_lock(&trace_lock);
+    bool have_spare = false;
+    for (trace_ring_t *ring = trace_rings.load(std::memory_order_relaxed); ring; ring = ring->next) {
+        have_spare = have_spare || ring->spare.load(std::memory_order_relaxed);
+    }
+    if (!have_spare) {
+        trace_add_ring(true);
+    }
+    pthread_mutex_unlock(&trace_lock);
+}
+
+void trace_audio_thread(void) {
+    if (thread_ring || !trace_active.load(std::memory_order_relaxed)) return;
+    thread_realtime = true;
+
+    // Claim a spare by walking the list, which only grows (no lock, no allocation)
+    for (trace_ring_t *ring = trace_rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        if (ring->spare.load(std::memory_order_relaxed) && ring->spare.exchange(false, std::memory_order_acquire)) {
+            thread_ring = ring;
+            return;
+        }
+    }
+}
+
+static void trace_write_separator(void) {
+    if (!trace_first_event) {
+        fputs(",\n", trace_file);
+    }
+    trace_first_event = false;
+}
+
+// Drain every ring into the output file (writer thread only)
+static void trace_flush_rings(void) {
+    int pid = (int)trace_getpid();
+
+    for (trace_ring_t *ring = trace_rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        if (ring->name_pending.exchange(false, std::memory_order_acquire)) {
+            trace_write_separator();
+            fprintf(trace_file,
+                    "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                    pid, ring->tid, ring->thread_name);
+        }
+
+        uint32_t read_pos = ring->read_pos.load(std::memory_order_relaxed);
+        uint32_t write_pos = ring->write_pos.load(std::memory_order_acquire);
+
+        for (; read_pos != write_pos; ++read_pos) {
+            const trace_event_t *event = &ring->events[read_pos & (TRACE_RING_SIZE - 1)];
+            double ts_us = (double)(event->timestamp_ns - trace_start_ns) / 1000.0;
+
+            trace_write_separator();
+            fprintf(trace_file, "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u}",
+                    event->name, event->phase, ts_us, pid, ring->tid);
+        }
+
+        ring->read_pos.store(read_pos, std::memory_order_release);
+    }
+
+    fflush(trace_file);
+}
+
+static void *trace_writer_thread(void *arg) {
+    (void)arg;
+
+    while (trace_thread_running.load(std::memory_order_acquire)) {
+        trace_sleep_ms(TRACE_FLUSH_INTERVAL_MS);
+        trace_flush_rings();
+    }
+
+    return NULL;
+}
+
+void trace_init(void) {
+    pthread_mutex_lock(&trace_lock);
+
+    if (trace_refcount++ == 0) {
+        const char *path = getenv("MATRIXFILTER_TRACE_FILE");
+        trace_file = (path && *path) ? fopen(path, "w") : NULL;
+
+        if (trace_file) {
+            fputs("[\n", trace_file);
+            trace_first_event = true;
+            trace_start_ns = cpu_meter_now_ns();
+            trace_thread_running.store(true, std::memory_order_release);
+
+            if (pthread_create(&trace_thread, NULL, trace_writer_thread, NULL) == 0) {
+                trace_active.store(true, std::memory_order_release);
+            } else {
+                trace_thread_running.store(false, std::memory_order_relaxed);
+                fclose(trace_file);
+                trace_file = NULL;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&trace_lock);
+}
+
+void trace_shutdown(void) {
+    pthread_mutex_lock(&trace_lock);
+
+    if (trace_refcount > 0 && --trace_refcount == 0 && trace_file) {
+        trace_active.store(false, std::memory_order_release);
+        trace_thread_running.store(false, std::memory_order_release);
+
+        // The writer never takes trace_lock, so joining under it is safe
+        pthread_join(trace_thread, NULL);
+        trace_flush_rings();
+
+        uint32_t dropped = 0;
+        for (trace_ring_t *ring = trace_rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+            dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+        }
+        if (dropped > 0) {
+            fprintf(stderr, "trace: dropped %u events (ring full)\n", dropped);
+        }
+
+        fputs("\n]\n", trace_file);
+        fclose(trace_file);
+        trace_file = NULL;
+    }
+
+    pthread_mutex_unlock(&trace_lock);
+}
@@ -20,6 +20,7 @@ public:
         parameters.addParameter(new Parameter("Gain", "dB", -60, 60, 0, ParameterFlags::kCanAutomate));
         parameters.addParameter(new Parameter("Filter Type", "", 0, 6, 0, ParameterFlags::kCanAutomate | ParameterFlags::kIsBypass));
         parameters.addParameter(new Parameter("Enabled", "", 0, 1, 1, ParameterFlags::kCanAutomate | ParameterFlags::kIsBypass));
+        parameters.addParameter(new Parameter("Channel Mode", "", 0, 2, 0, ParameterFlags::kCanAutomate));
     }
 
     tresult PLUGIN_API initialize(FUnknown* context) override {
@@ -53,6 +54,9 @@ public:
         if (state->read(&paramBool, sizeof(bool)) == kResultOk) {
             parameters.getParameter(4)->setNormalized(paramBool ? 1.0 : 0.0); // Enabled
         }
+        if (state->read(&paramInt, sizeof(int32_t)) == kResultOk) {
+            parameters.getParameter(5)->setNormalized(paramInt / 2.0); // Channel Mode
+        }
         
         return kResultOk;
     }
@@ -89,6 +93,15 @@ public:
             case 4: // Enabled
                 strcpy16(string, valueNormalized >= 0.5 ? u8"On" : u8"Off");
                 break;
+            case 5: // Channel Mode
+                {
+                    const char16* modeNames[] = {u"L/R", u"Mid", u"Side"};
+                    int index = (int)(valueNormalized * 2.0 + 0.5);
+                    if (index >= 0 && index < 3) {
+                        strcpy16(string, modeNames[index]);
+                    }
+                }
+                break;
         }
         return kResultOk;
     }
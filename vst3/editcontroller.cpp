@@ -7,31 +7,150 @@
 #include "public.sdk/source/common/uidescriptionwindowcontroller.h"
 #include "pluginterfaces/vst/ivsteditcontroller.h"
 #include "pluginterfaces/vst/ivstgui.h"
+#include "pluginterfaces/gui/iplugviewcontentscalesupport.h"
 #include "pluginterfaces/vst/ivstaudioprocessor.h"
+#include "vstgui/lib/cvstguitimer.h"
 #include "../src/gui.h"
+#include "cpu_meter.h"
+#include "level_meter.h"
+#include "loudness.h"
+#include "background.h"
+#include "gl_window.h"
+#include "meter-messages.h"
 
 using namespace Steinberg;
 using namespace Steinberg::Vst;
 
+// Editor-only parameters, after the processor's six (the processor ignores them)
+enum {
+    kAnalysisSizeParam = 6,     // FFT size index: 256 << index
+    kAnalysisOverlapParam = 7,  // segment overlap, percent
+    kSpectrumModeParam = 8      // ANALYSIS_MODE_*
+};
+#define ANALYSIS_SIZE_STEPS 6
+
 class MatrixFlangerGUI : public CView {
 public:
     MatrixFlangerGUI(const CRect& size, const CColor& color) 
         : CView(size), backgroundColor(color) {
-        // Initialize OpenGL context
-        initOpenGL();
+        // Blue-on-dark-blue matrix pattern, computed per pixel by a shared shader
+        background_init(&backdrop, 1.0f);
+        
+        // Frames are paced by the overlay's scheduler: the timer sleeps until the
+        // next deadline and only renders when a frame is due
+        frameTimer = makeOwned<CVSTGUITimer>([this](CVSTGUITimer* timer) { onFrameTimer(timer); },
+                                             (uint32_t)(1000.0 / FRAME_SCHEDULER_IDLE_HZ), false);
     }
     
     ~MatrixFlangerGUI() override {
-        cleanupOpenGL();
+        close();
+    }
+    
+    // Open the editor window inside the host's parent window. Its GL context
+    // joins the process-wide cache group, so shaders and the glyph atlas are
+    // shared with every other open editor.
+    bool open(void* parent) {
+        close();
+        
+        const CRect& size = getViewSize();
+        if (!gl_window_create(&window, parent, (uint32_t)size.getWidth(), (uint32_t)size.getHeight())) {
+            return false;
+        }
+        
+        // Overlay state (status, activity, meters); GL objects are created on the first frame
+        if (!gui_create(&gui, nullptr, (uint32_t)size.getWidth(), (uint32_t)size.getHeight())) {
+            gl_window_destroy(&window);
+            return false;
+        }
+        gui_set_scale_factor(&gui, scaleFactor);
+        gui_set_cpu_meter(&gui, cpuMeter);
+        gui_set_level_meter(&gui, levelMeter);
+        gui_set_loudness_meter(&gui, loudnessMeter);
+        gui_set_analysis(&gui, analysisSize, analysisOverlap);
+        gui_set_spectrum_mode(&gui, spectrumMode);
+        
+        // No GL context: backdrop and overlay are rasterised in software and
+        // shown by the window instead
+        if (!gl_window_has_gl(&window) &&
+            (!gui_set_backend(&gui, GUI_BACKEND_SOFTWARE) ||
+             !soft_framebuffer_set_background(gui_framebuffer(&gui), background_fill, &backdrop))) {
+            gui_destroy(&gui);
+            gl_window_destroy(&window);
+            return false;
+        }
+        opened = true;
+        return true;
+    }
+    
+    // Release the GL objects with the context current, then leave the cache group
+    void close() {
+        if (!opened) return;
+        
+        frameTimer->stop();
+        gl_window_make_current(&window);
+        background_destroy(&backdrop);
+        gui_destroy(&gui);
+        gl_window_destroy(&window);
+        opened = false;
     }
     
     void draw(CDrawContext* pContext) override {
-        // Clear background
-        pContext->setFillColor(backgroundColor);
-        pContext->fillRect(getViewSize());
+        // The view has a window of its own; host repaints just show the latest frame
+        renderFrame();
+    }
+    
+    void setCpuMeter(cpu_meter_t* meter) {
+        cpuMeter = meter;
+        if (opened) gui_set_cpu_meter(&gui, meter);
+    }
+    
+    void setLevelMeter(level_meter_t* meter) {
+        levelMeter = meter;
+        if (opened) gui_set_level_meter(&gui, meter);
+    }
+    
+    void setLoudnessMeter(const loudness_meter_t* meter) {
+        loudnessMeter = meter;
+        if (opened) gui_set_loudness_meter(&gui, meter);
+    }
+    
+    void setVisible(bool state) override {
+        CView::setVisible(state);
+        if (!opened) return;
+        gui_set_visible(&gui, state);
         
-        // Draw matrix effect
-        drawMatrixEffect();
+        // Hidden editors get no frames at all
+        if (state) {
+            frameTimer->setFireTime(gui_frame_wait_ms(&gui));
+            frameTimer->start();
+        } else {
+            frameTimer->stop();
+        }
+    }
+    
+    void setViewSize(const CRect& rect, bool invalid = true) override {
+        CView::setViewSize(rect, invalid);
+        if (!opened) return;
+        
+        // Window and grid follow the new size (buffers are only reallocated here, not per frame)
+        gl_window_resize(&window, (uint32_t)rect.getWidth(), (uint32_t)rect.getHeight());
+        gui_resize(&gui, (uint32_t)rect.getWidth(), (uint32_t)rect.getHeight());
+    }
+    
+    void setScaleFactor(float factor) {
+        scaleFactor = factor;
+        if (opened) gui_set_scale_factor(&gui, factor);
+    }
+    
+    void setAnalysis(uint32_t fftSize, uint32_t overlapPercent) {
+        analysisSize = fftSize;
+        analysisOverlap = overlapPercent;
+        if (opened) gui_set_analysis(&gui, fftSize, overlapPercent);
+    }
+    
+    void setSpectrumMode(uint32_t mode) {
+        spectrumMode = mode;
+        if (opened) gui_set_spectrum_mode(&gui, mode);
     }
     
     void onMouseDown(CPoint& where, const CButtonState& buttons) override {
@@ -56,94 +175,71 @@ public:
     
 private:
     CColor backgroundColor;
-    GLuint textureID;
+    background_pass_t backdrop;
+    gl_window_t window = {};
+    gui_context_t gui;
+    bool opened = false;
+    SharedPointer<CVSTGUITimer> frameTimer;
     
-    void initOpenGL() {
-        // Initialize OpenGL for VST3 GUI
-        // This would need proper OpenGL context setup for VST3
-        // For now, we'll use a simple implementation
-        
-        // Create a simple texture for matrix effect
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        
-        // Create matrix visualization data
-        createMatrixTexture();
-    }
+    // Kept while the window is closed and handed to the overlay when it opens
+    float scaleFactor = 1.0f;
+    cpu_meter_t* cpuMeter = nullptr;
+    level_meter_t* levelMeter = nullptr;
+    const loudness_meter_t* loudnessMeter = nullptr;
+    uint32_t analysisSize = ANALYSIS_DEFAULT_FFT_SIZE;
+    uint32_t analysisOverlap = ANALYSIS_DEFAULT_OVERLAP;
+    uint32_t spectrumMode = ANALYSIS_MODE_LOG_FFT;
     
-    void cleanupOpenGL() {
-        if (textureID) {
-            glDeleteTextures(1, &textureID);
+    void onFrameTimer(CVSTGUITimer* timer) {
+        // Render only when a frame is due (display rate, or the idle rate once settled)
+        if (gui_update(&gui, nullptr, 0, 0.0)) {
+            renderFrame();
         }
+        timer->setFireTime(gui_frame_wait_ms(&gui));
     }
     
-    void createMatrixTexture() {
-        // Create a simple matrix effect texture
-        const int width = 512;
-        const int height = 512;
-        unsigned char* data = new unsigned char[width * height * 3];
+    void renderFrame() {
+        if (!opened) return;
         
-        // Simple matrix-like pattern
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                int index = (y * width + x) * 3;
-                
-                // Create blue-on-dark-blue matrix effect
-                float brightness = (sin(x * 0.01 + y * 0.01) + 1.0) * 0.5;
-                
-                data[index + 0] = 0;     // Red
-                data[index + 1] = (unsigned char)(brightness * 64); // Small amount of green for depth
-                data[index + 2] = (unsigned char)(brightness * 255); // Blue
-            }
+        // Software: the backdrop is the framebuffer's background, so the overlay
+        // pass restores and redraws only the rows that changed
+        soft_framebuffer_t* frame = gui_framebuffer(&gui);
+        if (frame) {
+            gui_render_overlay(&gui);
+            gl_window_present(&window, frame);
+            return;
         }
+        if (!gl_window_make_current(&window)) return;
         
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // Backdrop over the whole window; without shaders the background colour stays
+        opengl_setup_projection(window.width, window.height);
+        glClearColor(backgroundColor.red / 255.0f, backgroundColor.green / 255.0f, backgroundColor.blue / 255.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        background_draw(&backdrop);
         
-        delete[] data;
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-    
-    void drawMatrixEffect() {
-        // Draw the matrix effect on the VST3 GUI
-        CRect rect = getViewSize();
-        
-        // Enable blending for transparency effects
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        
-        // Bind and draw the matrix texture
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        
-        // Calculate viewport size
-        float viewportX = rect.left;
-        float viewportY = rect.top;
-        float viewportWidth = rect.width();
-        float viewportHeight = rect.height();
-        
-        // Draw textured quad
-        glBegin(GL_QUADS);
-            glTexCoord2f(0.0f, 0.0f); glVertex2f(viewportX, viewportY);
-            glTexCoord2f(1.0f, 0.0f); glVertex2f(viewportX + viewportWidth, viewportY);
-            glTexCoord2f(1.0f, 1.0f); glVertex2f(viewportX + viewportWidth, viewportY + viewportHeight);
-            glTexCoord2f(0.0f, 1.0f); glVertex2f(viewportX, viewportY + viewportHeight);
-        glEnd();
-        
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glDisable(GL_BLEND);
+        // Overlay as of the last frame the scheduler let through
+        gui_render_overlay(&gui);
+        gl_window_swap(&window);
     }
 };
 
-class MatrixFlangerEditController : public EditController, public IPlugView {
+class MatrixFlangerEditController : public EditController, public IPlugView, public IPlugViewContentScaleSupport {
 public:
-    MatrixFlangerEditController() : EditController(), pluginView(nullptr) {
+    MatrixFlangerEditController() : EditController(), pluginView(nullptr), cpuMeter(nullptr), levelMeter(nullptr), loudnessMeter(nullptr) {
         // Add parameters for GUI control
         parameters.addParameter(new Parameter("Cutoff Frequency", "Hz", 0, 20000, 1000, ParameterFlags::kCanAutomate));
         parameters.addParameter(new Parameter("Resonance", "", 0.1, 10.0, 1.0, ParameterFlags::kCanAutomate));
         parameters.addParameter(new Parameter("Gain", "dB", -60, 60, 0, ParameterFlags::kCanAutomate));
         parameters.addParameter(new Parameter("Filter Type", "", 0, 6, 0, ParameterFlags::kCanAutomate | ParameterFlags::kIsBypass));
         parameters.addParameter(new Parameter("Enabled", "", 0, 1, 1, ParameterFlags::kCanAutomate | ParameterFlags::kIsBypass));
+        parameters.addParameter(new Parameter("Channel Mode", "", 0, 2, 0, ParameterFlags::kCanAutomate));
+        
+        // Spectrum analysis settings (editor only, not automatable)
+        parameters.addParameter(new Parameter("Analysis Size", "", 0, ANALYSIS_SIZE_STEPS, 3, 0));
+        parameters.addParameter(new Parameter("Analysis Overlap", "%", ANALYSIS_MIN_OVERLAP, ANALYSIS_MAX_OVERLAP,
+                                              ANALYSIS_DEFAULT_OVERLAP, 0));
+        parameters.addParameter(new Parameter("Spectrum Mode", "", ANALYSIS_MODE_LOG_FFT, ANALYSIS_MODE_CONSTANT_Q,
+                                              ANALYSIS_MODE_LOG_FFT, 0));
     }
 
     ~MatrixFlangerEditController() override {
@@ -152,6 +248,15 @@ public:
         }
     }
 
+    // Expose the view interfaces (hosts only call setContentScaleFactor after
+    // querying for IPlugViewContentScaleSupport); everything else is EditController's
+    OBJ_METHODS(MatrixFlangerEditController, EditController)
+    DEFINE_INTERFACES
+        DEF_INTERFACE(IPlugView)
+        DEF_INTERFACE(IPlugViewContentScaleSupport)
+    END_DEFINE_INTERFACES(EditController)
+    REFCOUNT_METHODS(EditController)
+
     tresult PLUGIN_API initialize(FUnknown* context) override {
         tresult result = EditController::initialize(context);
         if (result == kResultOk) {
@@ -172,6 +277,10 @@ public:
         
         pluginView = new MatrixFlangerGUI(viewRect, bgColor);
         pluginView->remember();
+        pluginView->setCpuMeter(cpuMeter);
+        pluginView->setLevelMeter(levelMeter);
+        pluginView->setLoudnessMeter(loudnessMeter);
+        applyAnalysis();
         
         *view = this;
         return kResultOk;
@@ -182,13 +291,95 @@ public:
         return EditController::setComponentState(state);
     }
 
+    tresult PLUGIN_API setParamNormalized(ParamID id, ParamValue valueNormalized) override {
+        tresult result = EditController::setParamNormalized(id, valueNormalized);
+        if (id == kAnalysisSizeParam || id == kAnalysisOverlapParam || id == kSpectrumModeParam) {
+            applyAnalysis();
+        }
+        return result;
+    }
+
+    tresult PLUGIN_API setState(IBStream* state) override {
+        if (!state) return kInvalidArgument;
+        
+        // Editor-only settings, stored normalized
+        double param;
+        if (state->read(&param, sizeof(double)) == kResultOk) {
+            setParamNormalized(kAnalysisSizeParam, param);
+        }
+        if (state->read(&param, sizeof(double)) == kResultOk) {
+            setParamNormalized(kAnalysisOverlapParam, param);
+        }
+        if (state->read(&param, sizeof(double)) == kResultOk) {
+            setParamNormalized(kSpectrumModeParam, param);
+        }
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API getState(IBStream* state) override {
+        if (!state) return kInvalidArgument;
+        
+        double param = getParamNormalized(kAnalysisSizeParam);
+        state->write(&param, sizeof(double));
+        param = getParamNormalized(kAnalysisOverlapParam);
+        state->write(&param, sizeof(double));
+        param = getParamNormalized(kSpectrumModeParam);
+        state->write(&param, sizeof(double));
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API notify(IMessage* message) override {
+        if (message && strcmp(message->getMessageID(), METER_MESSAGE_CPU) == 0) {
+            // Processor shares its CPU meter, or revokes it with a null address
+            cpuMeter = (cpu_meter_t*)meter_message_address(message);
+            if (pluginView) {
+                pluginView->setCpuMeter(cpuMeter);
+            }
+            return kResultOk;
+        }
+        if (message && strcmp(message->getMessageID(), METER_MESSAGE_LEVEL) == 0) {
+            // Processor shares its output level meter, or revokes it with a null address
+            levelMeter = (level_meter_t*)meter_message_address(message);
+            if (pluginView) {
+                pluginView->setLevelMeter(levelMeter);
+            }
+            return kResultOk;
+        }
+        if (message && strcmp(message->getMessageID(), METER_MESSAGE_LOUDNESS) == 0) {
+            // Processor shares its loudness meter, or revokes it with a null address
+            loudnessMeter = (const loudness_meter_t*)meter_message_address(message);
+            if (pluginView) {
+                pluginView->setLoudnessMeter(loudnessMeter);
+            }
+            return kResultOk;
+        }
+        return EditController::notify(message);
+    }
+
+    // Processor CPU load (may be NULL until the processor has connected)
+    cpu_meter_t* getCpuMeter() const { return cpuMeter; }
+    
+    // Processor output levels (may be NULL until the processor has connected)
+    level_meter_t* getLevelMeter() const { return levelMeter; }
+    
+    // Processor output loudness (may be NULL until the processor has connected)
+    const loudness_meter_t* getLoudnessMeter() const { return loudnessMeter; }
+
     tresult PLUGIN_API attached(void* parent, FIDString type) override {
-        // GUI attached to parent window
+        // GUI attached to parent window: open the editor window and start rendering
+        if (!pluginView || !pluginView->open(parent)) {
+            return kResultFalse;
+        }
+        pluginView->setVisible(true);
         return kResultOk;
     }
 
     tresult PLUGIN_API removed() override {
-        // GUI removed from parent window
+        // GUI removed from parent window: close the editor window before the host destroys the parent
+        if (pluginView) {
+            pluginView->setVisible(false);
+            pluginView->close();
+        }
         return kResultOk;
     }
 
@@ -230,13 +421,17 @@ public:
         return kResultOk;
     }
 
-    tresult PLUGIN_API attached(void* parent, FIDString type) override {
-        // Attach to parent window
-        return IPlugView::attached(parent, type);
-    }
-
    tresult PLUGIN_API setGeometry(const ViewRect* rect) override {
         // Set geometry of the view
+        return onSize(const_cast<ViewRect*>(rect));
+    }
+
+    tresult PLUGIN_API onSize(ViewRect* newSize) override {
+        // Host resized the editor
+        if (!newSize) return kInvalidArgument;
+        if (pluginView) {
+            pluginView->setViewSize(CRect(newSize->left, newSize->top, newSize->right, newSize->bottom));
+        }
         return kResultOk;
     }
 
@@ -246,7 +441,22 @@ public:
     }
 
     tresult PLUGIN_API checkSizeConstraint(ViewRect* rect) override {
-        // Check if size constraint is satisfied
+        // Clamp the proposed size to what the editor supports
+        if (!rect) return kInvalidArgument;
+        
+        int32_t width = rect->getWidth();
+        int32_t height = rect->getHeight();
+        gui_constrain_size(&width, &height);
+        rect->right = rect->left + width;
+        rect->bottom = rect->top + height;
+        return kResultTrue;
+    }
+
+    tresult PLUGIN_API setContentScaleFactor(ScaleFactor factor) override {
+        // HiDPI: the grid is laid out in logical pixels
+        if (pluginView) {
+            pluginView->setScaleFactor(factor);
+        }
         return kResultOk;
     }
 
@@ -255,5 +465,19 @@ public:
     }
 
 private:
+    // Hand the analysis parameters to the view as FFT size, overlap percent and mode
+    void applyAnalysis() {
+        if (!pluginView) return;
+        uint32_t sizeIndex = (uint32_t)(getParamNormalized(kAnalysisSizeParam) * ANALYSIS_SIZE_STEPS + 0.5);
+        uint32_t overlap = ANALYSIS_MIN_OVERLAP +
+            (uint32_t)(getParamNormalized(kAnalysisOverlapParam) * (ANALYSIS_MAX_OVERLAP - ANALYSIS_MIN_OVERLAP) + 0.5);
+        pluginView->setAnalysis(ANALYSIS_MIN_FFT_SIZE << sizeIndex, overlap);
+        pluginView->setSpectrumMode(getParamNormalized(kSpectrumModeParam) > 0.5 ? ANALYSIS_MODE_CONSTANT_Q
+                                                                                   : ANALYSIS_MODE_LOG_FFT);
+    }
+
     MatrixFlangerGUI* pluginView;
+    cpu_meter_t* cpuMeter;
+    level_meter_t* levelMeter;
+    const loudness_meter_t* loudnessMeter;
 };
\ No newline at end of file
@@ -0,0 +1,49 @@
+/*
+ * VST3 Meter Messages Shared Between Processor and Controller
+ * flark's MatrixFlanger - VST3 Version
+ */
+
+#pragma once
+
+#include "pluginterfaces/vst/ivstmessage.h"
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// The processor shares its meters by address. That only works when both
+// components live in one process, so every message carries the sender's
+// process id, and the processor sends a null address before its meters go away.
+#define METER_MESSAGE_CPU "CpuMeter"
+#define METER_MESSAGE_LEVEL "LevelMeter"
+#define METER_MESSAGE_LOUDNESS "LoudnessMeter"
+
+static inline Steinberg::int64 meter_message_process_id() {
+#ifdef _WIN32
+    return (Steinberg::int64)GetCurrentProcessId();
+#else
+    return (Steinberg::int64)getpid();
+#endif
+}
+
+// Fill in a meter message (NULL revokes the meter)
+static inline void meter_message_fill(Steinberg::Vst::IMessage* message, const char* id, const void* address) {
+    message->setMessageID(id);
+    message->getAttributes()->setInt("address", (Steinberg::int64)(intptr_t)address);
+    message->getAttributes()->setInt("process", meter_message_process_id());
+}
+
+// Meter address carried by a message: NULL when revoked or sent from another process
+static inline void* meter_message_address(Steinberg::Vst::IMessage* message) {
+    Steinberg::int64 address = 0;
+    Steinberg::int64 process = 0;
+    if (message->getAttributes()->getInt("address", address) != Steinberg::kResultOk ||
+        message->getAttributes()->getInt("process", process) != Steinberg::kResultOk ||
+        process != meter_message_process_id()) {
+        return nullptr;
+    }
+    return (void*)(intptr_t)address;
+}
@@ -10,6 +10,11 @@
 #include "pluginterfaces/vst/ivstaudioprocessor.h"
 #include "../src/dsp.h"
 #include "../src/gui.h"
+#include "cpu_meter.h"
+#include "level_meter.h"
+#include "loudness.h"
+#include "trace.h"
+#include "meter-messages.h"
 
 using namespace Steinberg;
 using namespace Steinberg::Vst;
@@ -41,10 +46,15 @@ public:
         addParameter(new Parameter(String("Gain"), String("dB"), -60, 60, 0, ParameterFlags::kCanAutomate));
         addParameter(new Parameter(String("Filter Type"), String(""), 0, 6, 0, ParameterFlags::kCanAutomate | ParameterFlags::kIsBypass));
         addParameter(new Parameter(String("Enabled"), String(""), 0, 1, 1, ParameterFlags::kCanAutomate | ParameterFlags::kIsBypass));
+        addParameter(new Parameter(String("Channel Mode"), String(""), 0, 2, 0, ParameterFlags::kCanAutomate));
 
-        // Initialize DSP
-        filter_init(&filter, FILTER_TYPE_LOWPASS, 1000.0f, 1.0f, 0.0f, 44100.0f);
+        // Initialize DSP (stereo bank, re-initialized if the bus width differs)
+        filter_bank_init(&filter, FILTER_TYPE_LOWPASS, 1000.0f, 1.0f, 0.0f, 44100.0f, 2, 1);
         current_sample_rate = 44100.0f;
+        cpu_meter_init(&cpu_meter);
+        level_meter_init(&level_meter);
+        loudness_meter_init(&loudness_meter, 44100.0f, 2);
+        TRACE_INIT();
         
         // Initialize parameters
         cutoff_freq = 1000.0f;
@@ -52,6 +62,11 @@ public:
         gain = 0.0f;
         filter_type = FILTER_TYPE_LOWPASS;
         enabled = true;
+        channel_mode = FILTER_CHANNEL_MODE_STEREO;
+    }
+
+    ~MatrixFlangerProcessor() override {
+        TRACE_SHUTDOWN();
     }
 
     tresult PLUGIN_API initialize(FUnknown* context) override {
@@ -64,16 +79,45 @@ public:
 
     tresult PLUGIN_API setActive(TBool state) override {
         if (state) {
-            filter_reset(&filter);
+            filter_bank_reset(&filter);
+            loudness_meter_reset(&loudness_meter);
+            
+            // Trace ring for the audio thread, so process() never allocates or locks for it
+            TRACE_RESERVE_AUDIO_RING();
         }
         return AudioProcessor::setActive(state);
     }
 
+    tresult PLUGIN_API connect(IConnectionPoint* other) override {
+        tresult result = AudioProcessor::connect(other);
+        if (result == kResultOk) {
+            // Hand the controller the meter addresses (ignored outside this process)
+            sendMeterMessage(METER_MESSAGE_CPU, &cpu_meter);
+            sendMeterMessage(METER_MESSAGE_LEVEL, &level_meter);
+            sendMeterMessage(METER_MESSAGE_LOUDNESS, &loudness_meter);
+        }
+        return result;
+    }
+
+    tresult PLUGIN_API disconnect(IConnectionPoint* other) override {
+        // Revoke the meters while the controller can still hear us
+        revokeMeters();
+        return AudioProcessor::disconnect(other);
+    }
+
+    tresult PLUGIN_API terminate() override {
+        revokeMeters();
+        return AudioProcessor::terminate();
+    }
+
     tresult PLUGIN_API process(ProcessData& data) override {
         if (!data.inputParameterChanges) {
             return kResultOk;
         }
 
+        TRACE_AUDIO_THREAD();
+        TRACE_SCOPE("process");
+        uint64_t blockStart = cpu_meter_now_ns();
         uint32_t nframes = data.numSamples;
         float sampleRate = getSampleRate();
         
@@ -105,34 +149,73 @@ public:
                         case 4: // Enabled
                             enabled = newValue >= 0.5;
                             break;
+                        case 5: // Channel Mode (normalized: 0 L/R, 0.5 Mid, 1 Side)
+                            channel_mode = (filter_channel_mode_t)(int)(newValue * 2.0 + 0.5);
+                            break;
                     }
                 }
             }
         }
 
-        // Update filter parameters
-        filter_set_parameters(&filter, filter_type, cutoff_freq, resonance, gain);
-        filter_set_sample_rate(&filter, sampleRate);
+        // Update filter parameters (kernel is re-selected only when they change)
+        filter_bank_set_parameters(&filter, filter_type, cutoff_freq, resonance, gain);
+        filter_bank_set_sample_rate(&filter, sampleRate);
 
         // Process audio if input and output are valid
         if (data.inputs[0].channelBuffers32 && data.outputs[0].channelBuffers32) {
-            uint32_t numChannels = std::min(data.inputs[0].numChannels, data.outputs[0].numChannels);
+            uint32_t busChannels = std::min(data.inputs[0].numChannels, data.outputs[0].numChannels);
+            uint32_t numChannels = std::min(busChannels, (uint32_t)FILTER_MAX_CHANNELS);
+            
+            const float* inputs[FILTER_MAX_CHANNELS];
+            float* outputs[FILTER_MAX_CHANNELS];
+            bool connected = numChannels > 0;
             
             for (uint32_t ch = 0; ch < numChannels; ch++) {
-                float* input = data.inputs[0].channelBuffers32[ch];
-                float* output = data.outputs[0].channelBuffers32[ch];
-                
-                if (input && output) {
-                    if (enabled && filter.initialized) {
-                        filter_process_block(&filter, input, output, nframes);
-                    } else {
-                        // Bypass
-                        memcpy(output, input, nframes * sizeof(float));
+                inputs[ch] = data.inputs[0].channelBuffers32[ch];
+                outputs[ch] = data.outputs[0].channelBuffers32[ch];
+                connected = connected && inputs[ch] && outputs[ch];
+            }
+            
+            if (connected) {
+                if (enabled) {
+                    // Bus width changed: pick up a kernel for the new channel count
+                    if (filter.channels != numChannels) {
+                        filter_bank_init(&filter, filter_type, cutoff_freq, resonance, gain, sampleRate, numChannels, 1);
+                    }
+                    // Stereo buses can filter mid or side only (fused encode/filter/decode)
+                    filter_bank_set_channel_mode(&filter, channel_mode);
+                    filter_bank_process(&filter, inputs, outputs, nframes);
+                } else {
+                    // Bypass
+                    for (uint32_t ch = 0; ch < numChannels; ch++) {
+                        if (outputs[ch] != inputs[ch]) {
+                            memcpy(outputs[ch], inputs[ch], nframes * sizeof(float));
+                        }
                     }
                 }
+
+                // Output levels for the editor, in one pass over the block
+                level_meter_record(&level_meter, outputs, numChannels, nframes, sampleRate);
+                
+                // EBU R128 loudness and true peak of the first two output channels
+                uint32_t loudnessChannels = std::min(numChannels, (uint32_t)LOUDNESS_CHANNELS);
+                if (loudness_meter.sample_rate != sampleRate || loudness_meter.channels != loudnessChannels) {
+                    loudness_meter_init(&loudness_meter, sampleRate, loudnessChannels);
+                }
+                loudness_meter_process(&loudness_meter, outputs, nframes);
+            }
+            
+            // Channels beyond what the filter bank holds pass through unfiltered
+            for (uint32_t ch = numChannels; ch < busChannels; ch++) {
+                const float* input = data.inputs[0].channelBuffers32[ch];
+                float* output = data.outputs[0].channelBuffers32[ch];
+                if (input && output && output != input) {
+                    memcpy(output, input, nframes * sizeof(float));
+                }
             }
         }
 
+        cpu_meter_record(&cpu_meter, cpu_meter_now_ns() - blockStart, nframes, sampleRate);
         return kResultOk;
     }
 
@@ -143,6 +226,7 @@ public:
             case 2: gain = (float)valueNormalized; break;
             case 3: filter_type = (filter_type_t)(int)valueNormalized; break;
             case 4: enabled = valueNormalized >= 0.5; break;
+            case 5: channel_mode = (filter_channel_mode_t)(int)(valueNormalized * 2.0 + 0.5); break;
         }
         return AudioProcessor::setParamNormalized(id, valueNormalized);
     }
@@ -154,6 +238,7 @@ public:
             case 2: return gain;
             case 3: return (float)filter_type;
             case 4: return enabled ? 1.0 : 0.0;
+            case 5: return channel_mode / 2.0;
         }
         return 0.0;
     }
@@ -181,6 +266,15 @@ public:
             case 4: // Enabled
                 strcpy16(string, valueNormalized >= 0.5 ? u8"On" : u8"Off");
                 break;
+            case 5: // Channel Mode
+                {
+                    const char16* modeNames[] = {u"L/R", u"Mid", u"Side"};
+                    int index = (int)(valueNormalized * 2.0 + 0.5);
+                    if (index >= 0 && index < 3) {
+                        strcpy16(string, modeNames[index]);
+                    }
+                }
+                break;
         }
         return kResultOk;
     }
@@ -208,7 +302,11 @@ public:
         state->read(&paramInt, sizeof(int32_t)); filter_type = (filter_type_t)paramInt;
         state->read(&paramBool, sizeof(bool)); enabled = paramBool;
         
-        filter_set_parameters(&filter, filter_type, cutoff_freq, resonance, gain);
+        // Channel mode was added later: older states load as L/R
+        channel_mode = FILTER_CHANNEL_MODE_STEREO;
+        if (state->read(&paramInt, sizeof(int32_t)) == kResultOk) channel_mode = (filter_channel_mode_t)paramInt;
+        
+        filter_bank_set_parameters(&filter, filter_type, cutoff_freq, resonance, gain);
         
         return kResultOk;
     }
@@ -223,6 +321,8 @@ public:
         int32_t filterTypeInt = (int32_t)filter_type;
         state->write(&filterTypeInt, sizeof(int32_t));
         state->write(&enabled, sizeof(bool));
+        int32_t channelModeInt = (int32_t)channel_mode;
+        state->write(&channelModeInt, sizeof(int32_t));
         
         return kResultOk;
     }
@@ -241,13 +341,38 @@ public:
     }
 
 private:
-    filter_t filter;
+    void sendMeterMessage(const char* id, const void* address) {
+        if (IMessage* message = allocateMessage()) {
+            meter_message_fill(message, id, address);
+            sendMessage(message);
+            message->release();
+        }
+    }
+
+    // Null addresses, so the controller never reads meters that outlive us
+    void revokeMeters() {
+        sendMeterMessage(METER_MESSAGE_CPU, nullptr);
+        sendMeterMessage(METER_MESSAGE_LEVEL, nullptr);
+        sendMeterMessage(METER_MESSAGE_LOUDNESS, nullptr);
+    }
+
+    filter_bank_t filter;
     float current_sample_rate;
     
+    // Per-block CPU load, read by the editor
+    cpu_meter_t cpu_meter;
+    
+    // Output peak/RMS/correlation, read by the editor
+    level_meter_t level_meter;
+    
+    // Output loudness (momentary/short-term/integrated LUFS, true peak), read by the editor
+    loudness_meter_t loudness_meter;
+    
     // Parameters
     float cutoff_freq;
     float resonance;
     float gain;
     filter_type_t filter_type;
     bool enabled;
+    filter_channel_mode_t channel_mode;
 };
\ No newline at end of file
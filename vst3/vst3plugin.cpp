@@ -126,13 +126,14 @@ private:
         Steinberg::tresult PLUGIN_API checkSizeConstraint(Steinberg::ViewRect* rect) override {
             if (!rect) return Steinberg::kInvalidArgument;
             
-            // Minimum and maximum size constraints
-            rect->right = std::min(rect->right, (Steinberg::int32)(rect->left + 800));
-            rect->bottom = std::min(rect->bottom, (Steinberg::int32)(rect->top + 600));
-            rect->left = std::max(rect->left, (Steinberg::int32)(rect->right - 600));
-            rect->top = std::max(rect->top, (Steinberg::int32)(rect->bottom - 400));
+            // Clamp the proposed size to what the editor supports
+            int32_t width = rect->getWidth();
+            int32_t height = rect->getHeight();
+            gui_constrain_size(&width, &height);
+            rect->right = rect->left + width;
+            rect->bottom = rect->top + height;
             
-            return Steinberg::kResultOk;
+            return Steinberg::kResultTrue;
         }
     };
 };